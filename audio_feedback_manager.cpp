@@ -1,11 +1,15 @@
 #include "audio_feedback_manager.h"
 
+#include "audio_mixer.h"
+#include "boot_timeline.h"
 #include "codec_board.h"
 #include "codec_init.h"
 #include "esp_codec_dev.h"
+#include "esp_heap_caps.h"
+#include "rssi_sonifier.h"
+#include "tone_synth.h"
 
 #include <Arduino.h>
-#include <math.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -20,20 +24,59 @@ constexpr int kSampleRate = 16000;
 constexpr int kChannels = 2;
 constexpr int kBitsPerSample = 16;
 constexpr int kChunkFrames = 256;
-constexpr float kPi = 3.14159265358979323846f;
+// Everything is mixed in 4 ms chunks: a new sound, a preemption or an RSSI change waits for the
+// next chunk boundary, never for the end of another sound.
+constexpr int kMixChunkFrames = 64;
+constexpr uint16_t kFadeMs = 8;
 
+// Values double as mixer sound ids.
 enum class AudioEvent : uint8_t {
     Startup,
     Shutdown,
     Detect,
+    // No sound: wakes a closed stream so sonification can start.
+    Wake,
+};
+
+struct AudioRequest {
+    AudioEvent event;
+    // micros() at enqueue, for queue-to-first-sample latency.
+    uint32_t queued_us;
+};
+
+// Sounds are rendered once from these tone lists, then replayed from PCM.
+constexpr ToneSpec kStartupTones[] = {
+    {660, 130, tone_gain_q15(0.42f), 20},
+    {990, 170, tone_gain_q15(0.40f), 0},
+};
+constexpr ToneSpec kShutdownTones[] = {
+    {880, 70, tone_gain_q15(0.38f), 10},
+    {520, 110, tone_gain_q15(0.40f), 0},
+};
+constexpr ToneSpec kDetectTones[] = {
+    {1400, 45, tone_gain_q15(0.32f), 8},
+    {1700, 45, tone_gain_q15(0.30f), 0},
+};
+
+// Mono PCM of one sound.
+struct PcmClip {
+    int16_t *samples;
+    uint32_t frame_count;
 };
 
 QueueHandle_t g_audio_queue = nullptr;
 TaskHandle_t g_audio_task = nullptr;
 volatile bool g_playing = false;
+volatile bool g_persistent_stream = true;
 
 bool g_codec_ready = false;
 esp_codec_dev_handle_t g_playback = nullptr;
+PcmClip g_startup_clip = {};
+PcmClip g_shutdown_clip = {};
+PcmClip g_detect_clip = {};
+RssiSonifier g_sonifier;
+// Audio task only.
+AudioMixer g_mixer;
 
 bool codec_prepare() {
     if (g_codec_ready && g_playback) {
@@ -67,73 +110,143 @@ bool codec_prepare() {
     return true;
 }
 
-void play_tone(float frequency_hz, int duration_ms, float gain) {
-    if (!g_playback || frequency_hz <= 0.0f || duration_ms <= 0) {
-        return;
+bool render_clip(PcmClip *clip, const ToneSpec *tones, size_t count) {
+    const uint32_t frames = tone_sequence_frames(tones, count, kSampleRate);
+    const size_t bytes = frames * sizeof(int16_t);
+    void *ptr = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!ptr) {
+        ptr = heap_caps_malloc(bytes, MALLOC_CAP_8BIT);
     }
+    if (!ptr) {
+        Serial.printf("[AUDIO] clip alloc failed (%u bytes)\n", static_cast<unsigned>(bytes));
+        return false;
+    }
+    clip->samples = static_cast<int16_t *>(ptr);
+    clip->frame_count = tone_render_sequence(tones, count, kSampleRate, kFadeMs, clip->samples, frames);
+    return true;
+}
 
-    const int total_frames = (kSampleRate * duration_ms) / 1000;
-    const int fade_frames = (kSampleRate * 8) / 1000;
-
-    int16_t pcm[kChunkFrames * kChannels];
-    float phase = 0.0f;
-    const float phase_step = 2.0f * kPi * frequency_hz / static_cast<float>(kSampleRate);
-
-    int written = 0;
-    while (written < total_frames) {
-        const int chunk = (total_frames - written > kChunkFrames) ? kChunkFrames : (total_frames - written);
+void render_clips() {
+    tone_synth_init();
+    render_clip(&g_startup_clip, kStartupTones, sizeof(kStartupTones) / sizeof(kStartupTones[0]));
+    render_clip(&g_shutdown_clip, kShutdownTones, sizeof(kShutdownTones) / sizeof(kShutdownTones[0]));
+    render_clip(&g_detect_clip, kDetectTones, sizeof(kDetectTones) / sizeof(kDetectTones[0]));
+}
 
-        for (int i = 0; i < chunk; ++i) {
-            const int idx = written + i;
-            float env = 1.0f;
+// Blocks until the DMA ring has room.
+void write_silence(int frames) {
+    static int16_t silence[kChunkFrames * kChannels] = {0};
+    if (esp_codec_dev_write(g_playback, silence, frames * kChannels * sizeof(int16_t)) != 0) {
+        vTaskDelay(1);
+    }
+}
 
-            if (idx < fade_frames) {
-                env = static_cast<float>(idx) / static_cast<float>(fade_frames);
-            } else if (idx > total_frames - fade_frames) {
-                env = static_cast<float>(total_frames - idx) / static_cast<float>(fade_frames);
-            }
+// Renders one mixed chunk (sonification underneath, clips on top) to both channels. The write
+// blocks until the DMA ring has room, which paces the loop of an open stream.
+void write_mix_chunk() {
+    int16_t mono[kMixChunkFrames];
+    int16_t pcm[kMixChunkFrames * kChannels];
+    // A critical sound plays alone.
+    if (!g_sonifier.idle() && !g_mixer.exclusive()) {
+        g_sonifier.render(mono, kMixChunkFrames);
+    } else {
+        memset(mono, 0, sizeof(mono));
+    }
+    g_mixer.mix(mono, kMixChunkFrames, micros());
+    for (int i = 0; i < kMixChunkFrames; ++i) {
+        pcm[i * 2] = mono[i];
+        pcm[i * 2 + 1] = mono[i];
+    }
+    if (esp_codec_dev_write(g_playback, pcm, sizeof(pcm)) != 0) {
+        vTaskDelay(1);
+    }
+}
 
-            const float sample_f = sinf(phase) * gain * env;
-            const int16_t sample = static_cast<int16_t>(sample_f * 32767.0f);
+bool open_stream(esp_codec_dev_sample_info_t *fs) {
+    if (!codec_prepare()) {
+        return false;
+    }
+    const int open_ret = esp_codec_dev_open(g_playback, fs);
+    if (open_ret != 0) {
+        Serial.printf("[AUDIO] esp_codec_dev_open failed: %d\n", open_ret);
+        return false;
+    }
+    const int mute_ret = esp_codec_dev_set_out_mute(g_playback, false);
+    const int vol_ret = esp_codec_dev_set_out_vol(g_playback, 95);
+    Serial.printf("[AUDIO] stream opened mute=%d vol=%d\n", mute_ret, vol_ret);
+    return true;
+}
 
-            pcm[i * 2] = sample;
-            pcm[i * 2 + 1] = sample;
+void close_stream() {
+    write_silence(kChunkFrames);
+    const int close_ret = esp_codec_dev_close(g_playback);
+    Serial.printf("[AUDIO] stream closed ret=%d\n", close_ret);
+}
 
-            phase += phase_step;
-            if (phase > 2.0f * kPi) {
-                phase -= 2.0f * kPi;
-            }
-        }
+AudioPriority priority_for(AudioEvent evt) {
+    switch (evt) {
+        case AudioEvent::Shutdown:
+            // Must start before the power-cut deadline whatever is playing.
+            return AUDIO_PRIORITY_CRITICAL;
+        case AudioEvent::Startup:
+            return AUDIO_PRIORITY_NORMAL;
+        case AudioEvent::Detect:
+        default:
+            return AUDIO_PRIORITY_LOW;
+    }
+}
 
-        const int wr = esp_codec_dev_write(g_playback, pcm, chunk * kChannels * sizeof(int16_t));
-        if (wr != 0) {
-            Serial.printf("[AUDIO] write failed: %d\n", wr);
-            return;
-        }
-        written += chunk;
+const PcmClip &clip_for(AudioEvent evt) {
+    switch (evt) {
+        case AudioEvent::Startup:
+            return g_startup_clip;
+        case AudioEvent::Shutdown:
+            return g_shutdown_clip;
+        case AudioEvent::Detect:
+        default:
+            return g_detect_clip;
     }
 }
 
-void play_startup_sound() {
-    Serial.println("[AUDIO] startup tone1");
-    play_tone(660.0f, 130, 0.42f);
-    vTaskDelay(pdMS_TO_TICKS(20));
-    Serial.println("[AUDIO] startup tone2");
-    play_tone(990.0f, 170, 0.40f);
+const char *event_name(AudioEvent evt) {
+    switch (evt) {
+        case AudioEvent::Startup:
+            return "startup";
+        case AudioEvent::Shutdown:
+            return "shutdown";
+        case AudioEvent::Detect:
+            return "detect";
+        case AudioEvent::Wake:
+        default:
+            return "wake";
+    }
 }
 
-void play_shutdown_sound() {
-    Serial.println("[AUDIO] shutdown tone1");
-    play_tone(880.0f, 70, 0.38f);
-    vTaskDelay(pdMS_TO_TICKS(10));
-    Serial.println("[AUDIO] shutdown tone2");
-    play_tone(520.0f, 110, 0.40f);
+void print_latency(AudioEvent evt) {
+    const MixerLatencyStats &stats = g_mixer.latency(static_cast<uint8_t>(evt));
+    if (stats.count == 0) {
+        return;
+    }
+    Serial.printf("[AUDIO] latence %s: derniere %lu us, moy %lu us, max %lu us (%lu sons)\n",
+                  event_name(evt),
+                  static_cast<unsigned long>(stats.last_us),
+                  static_cast<unsigned long>(stats.total_us / stats.count),
+                  static_cast<unsigned long>(stats.max_us),
+                  static_cast<unsigned long>(stats.count));
 }
 
-void play_detect_sound() {
-    play_tone(1400.0f, 45, 0.32f);
-    vTaskDelay(pdMS_TO_TICKS(8));
-    play_tone(1700.0f, 45, 0.30f);
+// Detect beeps are frequent: their latency is only reported alongside the rare sounds.
+void log_finished(uint32_t mask) {
+    if (mask & (1UL << static_cast<uint8_t>(AudioEvent::Startup))) {
+        Serial.println("[AUDIO] startup sound done");
+        print_latency(AudioEvent::Startup);
+        print_latency(AudioEvent::Detect);
+    }
+    if (mask & (1UL << static_cast<uint8_t>(AudioEvent::Shutdown))) {
+        Serial.println("[AUDIO] shutdown sound done");
+        print_latency(AudioEvent::Shutdown);
+        print_latency(AudioEvent::Detect);
+    }
 }
 
 void audio_task(void *arg) {
@@ -144,42 +257,55 @@ void audio_task(void *arg) {
     fs.channel = kChannels;
     fs.bits_per_sample = kBitsPerSample;
 
+    render_clips();
+    // Bring the codec up right away, in parallel with the rest of boot, instead of on the first sound.
+    if (codec_prepare()) {
+        boot_timeline_mark(BOOT_PHASE_CODEC);
+    }
+
+    bool stream_open = false;
     for (;;) {
-        AudioEvent evt;
-        if (xQueueReceive(g_audio_queue, &evt, portMAX_DELAY) != pdTRUE) {
-            continue;
+        // Sonification keeps the stream open until its fade-out is done.
+        const bool busy = g_mixer.active() || !g_sonifier.idle();
+        const bool want_open = g_persistent_stream || busy;
+        if (want_open && !stream_open) {
+            stream_open = open_stream(&fs);
+        } else if (!want_open && stream_open) {
+            close_stream();
+            stream_open = false;
         }
 
-        if (!codec_prepare()) {
-            continue;
+        // Open stream: drain requests between chunks. Closed: sleep until one comes.
+        AudioRequest req;
+        TickType_t wait = stream_open ? 0 : portMAX_DELAY;
+        while (xQueueReceive(g_audio_queue, &req, wait) == pdTRUE) {
+            wait = 0;
+            if (req.event == AudioEvent::Wake) {
+                continue;
+            }
+            g_playing = true;
+            const PcmClip &clip = clip_for(req.event);
+            const uint8_t id = static_cast<uint8_t>(req.event);
+            if (!g_mixer.start(id, clip.samples, clip.frame_count, priority_for(req.event), req.queued_us)) {
+                Serial.printf("[AUDIO] %s dropped (priority)\n", event_name(req.event));
+            }
         }
 
-        g_playing = true;
-        const int open_ret = esp_codec_dev_open(g_playback, &fs);
-        if (open_ret != 0) {
-            Serial.printf("[AUDIO] esp_codec_dev_open failed: %d\n", open_ret);
-            g_playing = false;
-            continue;
-        }
-        const int mute_ret = esp_codec_dev_set_out_mute(g_playback, false);
-        const int vol_ret = esp_codec_dev_set_out_vol(g_playback, 95);
-        Serial.printf("[AUDIO] stream opened mute=%d vol=%d\n", mute_ret, vol_ret);
-
-        if (evt == AudioEvent::Startup) {
-            play_startup_sound();
-            Serial.println("[AUDIO] startup sound done");
-        } else if (evt == AudioEvent::Shutdown) {
-            play_shutdown_sound();
-            Serial.println("[AUDIO] shutdown sound done");
-        } else {
-            play_detect_sound();
+        if (!stream_open) {
+            if (!g_mixer.active() && g_sonifier.idle()) {
+                continue;
+            }
+            stream_open = open_stream(&fs);
+            if (!stream_open) {
+                g_mixer = AudioMixer();
+                g_playing = false;
+                continue;
+            }
         }
 
-        int16_t silence[kChunkFrames * kChannels] = {0};
-        esp_codec_dev_write(g_playback, silence, sizeof(silence));
-        const int close_ret = esp_codec_dev_close(g_playback);
-        Serial.printf("[AUDIO] stream closed ret=%d\n", close_ret);
-        g_playing = false;
+        write_mix_chunk();
+        g_playing = g_mixer.active();
+        log_finished(g_mixer.take_finished());
     }
 }
 
@@ -188,10 +314,25 @@ void enqueue_event(AudioEvent evt) {
         return;
     }
 
-    if (xQueueSend(g_audio_queue, &evt, 0) != pdTRUE) {
-        AudioEvent dropped;
-        xQueueReceive(g_audio_queue, &dropped, 0);
-        xQueueSend(g_audio_queue, &evt, 0);
+    const AudioRequest req = {evt, static_cast<uint32_t>(micros())};
+    // Critical sounds jump the queue.
+    const bool critical = evt != AudioEvent::Wake && priority_for(evt) == AUDIO_PRIORITY_CRITICAL;
+    const BaseType_t sent = critical ? xQueueSendToFront(g_audio_queue, &req, 0) : xQueueSend(g_audio_queue, &req, 0);
+    if (sent == pdTRUE) {
+        return;
+    }
+
+    // Full: make room by dropping the oldest request, unless it outranks this one.
+    AudioRequest oldest;
+    if (xQueueReceive(g_audio_queue, &oldest, 0) == pdTRUE && oldest.event != AudioEvent::Wake &&
+        (evt == AudioEvent::Wake || priority_for(oldest.event) > priority_for(evt))) {
+        xQueueSendToFront(g_audio_queue, &oldest, 0);
+        return;
+    }
+    if (critical) {
+        xQueueSendToFront(g_audio_queue, &req, 0);
+    } else {
+        xQueueSend(g_audio_queue, &req, 0);
     }
 }
 
@@ -202,7 +343,8 @@ void audio_feedback_init() {
         return;
     }
 
-    g_audio_queue = xQueueCreate(4, sizeof(AudioEvent));
+    g_sonifier.configure(RssiSonifier::default_config(kSampleRate));
+    g_audio_queue = xQueueCreate(4, sizeof(AudioRequest));
     if (!g_audio_queue) {
         Serial.println("[AUDIO] queue creation failed");
         return;
@@ -231,6 +373,29 @@ void audio_feedback_play_detect() {
     enqueue_event(AudioEvent::Detect);
 }
 
+void audio_feedback_set_persistent_stream(bool enabled) {
+    g_persistent_stream = enabled;
+}
+
+void audio_feedback_set_sonify_mode(SonifyMode mode) {
+    if (mode == g_sonifier.mode()) {
+        return;
+    }
+    g_sonifier.set_mode(mode);
+    Serial.printf("[AUDIO] sonification: %s\n", sonify_mode_name(mode));
+    if (mode != SONIFY_OFF) {
+        enqueue_event(AudioEvent::Wake);
+    }
+}
+
+SonifyMode audio_feedback_get_sonify_mode() {
+    return g_sonifier.mode();
+}
+
+void audio_feedback_sonify_rssi(int rssi_dbm) {
+    g_sonifier.publish_rssi(rssi_dbm);
+}
+
 bool audio_feedback_is_idle() {
     if (!g_audio_queue) {
         return true;
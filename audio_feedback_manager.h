@@ -1,9 +1,26 @@
 #pragma once
 
+#include "rssi_sonifier.h"
+
 void audio_feedback_init();
 
+// Sounds are mixed by priority in 4 ms chunks: detect beeps mix with anything, the shutdown
+// sound cuts every other sound and starts at the next chunk boundary. Queue-to-first-sample
+// latency is logged when the startup and shutdown sounds finish.
 void audio_feedback_play_startup();
 void audio_feedback_play_shutdown();
 void audio_feedback_play_detect();
 
+// Persistent stream (default): the I2S stream stays open and is fed silence between sounds,
+// so a sound starts within a few ms instead of after a stream open. When disabled the stream
+// is closed after each sound; re-enabling takes effect from the next sound.
+void audio_feedback_set_persistent_stream(bool enabled);
+
+// Continuous RSSI sonification (pitch or Geiger clicks). While a mode is on the stream stays
+// open and the audio task synthesises 4 ms chunks from the latest published RSSI.
+void audio_feedback_set_sonify_mode(SonifyMode mode);
+SonifyMode audio_feedback_get_sonify_mode();
+// Lock-free, callable from the RF task on every pass.
+void audio_feedback_sonify_rssi(int rssi_dbm);
+
 bool audio_feedback_is_idle();
@@ -0,0 +1,196 @@
+#include "audio_mixer.h"
+
+namespace {
+
+int16_t clamp_s16(int32_t value) {
+    if (value > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (value < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return static_cast<int16_t>(value);
+}
+
+}  // namespace
+
+AudioMixer::Voice *AudioMixer::pick_slot(uint8_t sound_id, AudioPriority priority) {
+    // Same sound again: restart it rather than stacking copies; the old position fades out.
+    for (Voice &voice : voices_) {
+        if (voice.active && !voice.stopping && voice.sound_id == sound_id) {
+            return &voice;
+        }
+    }
+    for (Voice &voice : voices_) {
+        if (!voice.active) {
+            return &voice;
+        }
+    }
+    // All busy: steal the lowest-priority voice, the furthest along among equals.
+    Voice *victim = nullptr;
+    for (Voice &voice : voices_) {
+        if (voice.priority > priority) {
+            continue;
+        }
+        if (!victim || voice.priority < victim->priority ||
+            (voice.priority == victim->priority && voice.position > victim->position)) {
+            victim = &voice;
+        }
+    }
+    return victim;
+}
+
+// The slot's current sound is cut mid-clip: keep it as a tail faded over the next chunk so
+// the cut does not click. One that has not played a sample yet can go at once.
+void AudioMixer::hand_over(Voice &voice, uint8_t sound_id) {
+    if (!voice.active) {
+        return;
+    }
+    // A preempted voice was already on its way out, even when the same sound takes its slot.
+    const bool stolen = voice.stopping || voice.sound_id != sound_id;
+    if (!voice.started) {
+        if (stolen) {
+            finished_mask_ |= 1UL << voice.sound_id;
+        }
+        return;
+    }
+    voice.tail = voice.samples + voice.position;
+    voice.tail_frames = voice.frame_count - voice.position;
+    voice.tail_sound_id = voice.sound_id;
+    voice.tail_finishes = stolen;
+}
+
+void AudioMixer::mix_tail(Voice &voice, int16_t *out, uint32_t frames) {
+    const uint32_t count = (voice.tail_frames < frames) ? voice.tail_frames : frames;
+    for (uint32_t i = 0; i < count; ++i) {
+        const int32_t sample = (voice.tail[i] * static_cast<int32_t>(count - i)) / static_cast<int32_t>(count);
+        out[i] = clamp_s16(out[i] + sample);
+    }
+    if (voice.tail_finishes) {
+        finished_mask_ |= 1UL << voice.tail_sound_id;
+    }
+    voice.tail = nullptr;
+    voice.tail_frames = 0;
+}
+
+bool AudioMixer::start(uint8_t sound_id,
+                       const int16_t *samples,
+                       uint32_t frame_count,
+                       AudioPriority priority,
+                       uint32_t queued_us) {
+    if (!samples || frame_count == 0 || sound_id >= AUDIO_MIXER_MAX_SOUNDS) {
+        return false;
+    }
+    if (exclusive() && priority < AUDIO_PRIORITY_CRITICAL) {
+        return false;
+    }
+
+    Voice *voice = pick_slot(sound_id, priority);
+    if (!voice) {
+        return false;
+    }
+
+    if (priority == AUDIO_PRIORITY_CRITICAL) {
+        for (Voice &other : voices_) {
+            if (&other != voice && other.active && other.priority < AUDIO_PRIORITY_CRITICAL) {
+                other.stopping = true;
+            }
+        }
+    }
+
+    hand_over(*voice, sound_id);
+    voice->samples = samples;
+    voice->frame_count = frame_count;
+    voice->position = 0;
+    voice->queued_us = queued_us;
+    voice->sound_id = sound_id;
+    voice->priority = priority;
+    voice->active = true;
+    voice->started = false;
+    voice->stopping = false;
+    return true;
+}
+
+void AudioMixer::mix(int16_t *out, uint32_t frames, uint32_t now_us) {
+    if (!out || frames == 0) {
+        return;
+    }
+
+    for (Voice &voice : voices_) {
+        if (voice.tail) {
+            mix_tail(voice, out, frames);
+        }
+        if (!voice.active) {
+            continue;
+        }
+        // Preempted before its first sample: drop it silently.
+        if (voice.stopping && !voice.started) {
+            voice.active = false;
+            finished_mask_ |= 1UL << voice.sound_id;
+            continue;
+        }
+        if (!voice.started) {
+            voice.started = true;
+            MixerLatencyStats &stats = latency_[voice.sound_id];
+            const uint32_t latency_us = now_us - voice.queued_us;
+            stats.count++;
+            stats.last_us = latency_us;
+            stats.total_us += latency_us;
+            if (latency_us > stats.max_us) {
+                stats.max_us = latency_us;
+            }
+        }
+
+        const uint32_t remaining = voice.frame_count - voice.position;
+        const uint32_t count = (remaining < frames) ? remaining : frames;
+        const int16_t *src = voice.samples + voice.position;
+        for (uint32_t i = 0; i < count; ++i) {
+            int32_t sample = src[i];
+            if (voice.stopping) {
+                sample = (sample * static_cast<int32_t>(count - i)) / static_cast<int32_t>(count);
+            }
+            out[i] = clamp_s16(out[i] + sample);
+        }
+        voice.position += count;
+
+        if (voice.stopping || voice.position >= voice.frame_count) {
+            voice.active = false;
+            finished_mask_ |= 1UL << voice.sound_id;
+        }
+    }
+}
+
+bool AudioMixer::active() const {
+    for (const Voice &voice : voices_) {
+        if (voice.active) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AudioMixer::exclusive() const {
+    for (const Voice &voice : voices_) {
+        if (voice.active && voice.priority == AUDIO_PRIORITY_CRITICAL) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t AudioMixer::take_finished() {
+    const uint32_t mask = finished_mask_;
+    finished_mask_ = 0;
+    return mask;
+}
+
+const MixerLatencyStats &AudioMixer::latency(uint8_t sound_id) const {
+    static const MixerLatencyStats kEmpty = {};
+    return (sound_id < AUDIO_MIXER_MAX_SOUNDS) ? latency_[sound_id] : kEmpty;
+}
+
+void AudioMixer::reset_latency() {
+    for (MixerLatencyStats &stats : latency_) {
+        stats = {};
+    }
+}
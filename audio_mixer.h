@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdint.h>
+
+constexpr uint8_t AUDIO_MIXER_MAX_VOICES = 4;
+constexpr uint8_t AUDIO_MIXER_MAX_SOUNDS = 4;
+
+enum AudioPriority : uint8_t {
+    // Mixed with anything, first to be stolen.
+    AUDIO_PRIORITY_LOW = 0,
+    AUDIO_PRIORITY_NORMAL,
+    // Fades every lower voice out within one chunk and blocks new ones until it ends.
+    AUDIO_PRIORITY_CRITICAL,
+};
+
+// Request-to-first-sample latency of one sound, in microseconds.
+struct MixerLatencyStats {
+    uint32_t count;
+    uint32_t last_us;
+    uint32_t max_us;
+    uint64_t total_us;
+};
+
+// Chunked mixer over pre-rendered mono clips. Voices advance one chunk per mix() call, so a
+// start() takes effect at the next chunk boundary instead of after the sound playing now.
+// Plain C++, no FreeRTOS: drive it with a buffer and fake timestamps on the host.
+class AudioMixer {
+public:
+    // Starts (or restarts) sound_id. queued_us is when the request was made, for latency stats.
+    // Returns false when the request loses against the voices already playing.
+    bool start(uint8_t sound_id,
+               const int16_t *samples,
+               uint32_t frame_count,
+               AudioPriority priority,
+               uint32_t queued_us);
+
+    // Adds the active voices onto out (which may already hold a background layer) and
+    // advances them. now_us stamps the first sample of newly started voices.
+    void mix(int16_t *out, uint32_t frames, uint32_t now_us);
+
+    bool active() const;
+    // A critical voice is playing: background layers should stay silent.
+    bool exclusive() const;
+    // Bit per sound_id that finished since the last call.
+    uint32_t take_finished();
+
+    const MixerLatencyStats &latency(uint8_t sound_id) const;
+    void reset_latency();
+
+private:
+    struct Voice {
+        const int16_t *samples;
+        uint32_t frame_count;
+        uint32_t position;
+        uint32_t queued_us;
+        uint8_t sound_id;
+        AudioPriority priority;
+        bool active;
+        bool started;
+        // Preempted: ramps to zero over the next chunk, then frees the slot.
+        bool stopping;
+        // Sound this slot played before a steal or restart took it over: ramps to zero over
+        // the next chunk, under the new sound's first samples.
+        const int16_t *tail;
+        uint32_t tail_frames;
+        uint8_t tail_sound_id;
+        // Stolen rather than restarted: report the old sound finished once it has faded.
+        bool tail_finishes;
+    };
+
+    Voice *pick_slot(uint8_t sound_id, AudioPriority priority);
+    void hand_over(Voice &voice, uint8_t sound_id);
+    void mix_tail(Voice &voice, int16_t *out, uint32_t frames);
+
+    Voice voices_[AUDIO_MIXER_MAX_VOICES] = {};
+    MixerLatencyStats latency_[AUDIO_MIXER_MAX_SOUNDS] = {};
+    uint32_t finished_mask_ = 0;
+};
@@ -0,0 +1,185 @@
+#include "battery_estimator.h"
+
+#include <string.h>
+
+namespace {
+
+// EMA weight 1/4 per burst: a 10 s poll settles a step in about a minute.
+constexpr uint8_t kEmaShift = 2;
+// Publish thresholds.
+constexpr uint8_t kPercentStep = 2;
+constexpr uint8_t kStateHysteresisPct = 2;
+constexpr uint32_t kRuntimeStepMin = 5;
+// Drain needs this much history and at least 1% lost before a runtime is trusted; below that
+// ADC noise alone produces multi-day runtimes.
+constexpr uint32_t kMinRuntimeWindowMs = 5 * 60 * 1000;
+constexpr uint16_t kMinDrainX10 = 10;
+
+struct CurvePoint {
+    uint16_t millivolts;
+    uint16_t percent_x10;
+};
+
+// Single-cell Li-ion under light load, highest voltage first.
+constexpr CurvePoint kDischargeCurve[] = {
+    {4200, 1000}, {4150, 950}, {4110, 900}, {4080, 850}, {4020, 800}, {3980, 750}, {3950, 700},
+    {3910, 650},  {3870, 600}, {3850, 550}, {3840, 500}, {3820, 450}, {3800, 400}, {3790, 350},
+    {3770, 300},  {3750, 250}, {3730, 200}, {3710, 150}, {3690, 100}, {3610, 50},  {3400, 0},
+};
+constexpr size_t kCurvePoints = sizeof(kDischargeCurve) / sizeof(kDischargeCurve[0]);
+
+// Lower bounds of icon steps 1..4.
+constexpr uint8_t kStateThresholdPct[] = {10, 35, 60, 85};
+
+}  // namespace
+
+void BatteryEstimator::reset() {
+    *this = BatteryEstimator();
+}
+
+uint16_t BatteryEstimator::percent_x10_from_mv(uint16_t millivolts) {
+    if (millivolts >= kDischargeCurve[0].millivolts) {
+        return kDischargeCurve[0].percent_x10;
+    }
+    for (size_t i = 1; i < kCurvePoints; ++i) {
+        const CurvePoint &hi = kDischargeCurve[i - 1];
+        const CurvePoint &lo = kDischargeCurve[i];
+        if (millivolts >= lo.millivolts) {
+            return static_cast<uint16_t>(lo.percent_x10 + (static_cast<uint32_t>(millivolts - lo.millivolts) *
+                                                           (hi.percent_x10 - lo.percent_x10)) /
+                                                              (hi.millivolts - lo.millivolts));
+        }
+    }
+    return 0;
+}
+
+uint16_t BatteryEstimator::reject_sag(const uint16_t *millivolts, size_t count) const {
+    uint16_t sorted[BATTERY_EST_MAX_BURST];
+    if (count > BATTERY_EST_MAX_BURST) {
+        count = BATTERY_EST_MAX_BURST;
+    }
+    memcpy(sorted, millivolts, count * sizeof(uint16_t));
+    // Insertion sort, bursts are tiny.
+    for (size_t i = 1; i < count; ++i) {
+        const uint16_t value = sorted[i];
+        size_t j = i;
+        while (j > 0 && sorted[j - 1] > value) {
+            sorted[j] = sorted[j - 1];
+            --j;
+        }
+        sorted[j] = value;
+    }
+    // Load only ever pulls the voltage down: keep the upper half.
+    const size_t first = count / 2;
+    uint32_t sum = 0;
+    for (size_t i = first; i < count; ++i) {
+        sum += sorted[i];
+    }
+    return static_cast<uint16_t>(sum / (count - first));
+}
+
+uint8_t BatteryEstimator::state_for_percent(uint8_t percent) const {
+    uint8_t state = 0;
+    while (state < sizeof(kStateThresholdPct) && percent >= kStateThresholdPct[state]) {
+        ++state;
+    }
+    if (!has_published_ || state == published_.state) {
+        return state;
+    }
+    // Crossing back requires a margin so the icon does not flicker on a boundary.
+    if (state > published_.state && percent < kStateThresholdPct[state - 1] + kStateHysteresisPct) {
+        return published_.state;
+    }
+    if (state < published_.state && percent + kStateHysteresisPct > kStateThresholdPct[state]) {
+        return published_.state;
+    }
+    return state;
+}
+
+void BatteryEstimator::record_history(uint32_t now_ms) {
+    if (history_count_ > 0) {
+        const uint8_t newest = (history_head_ + BATTERY_EST_HISTORY - 1) % BATTERY_EST_HISTORY;
+        if (now_ms - history_[newest].time_ms < BATTERY_EST_HISTORY_STEP_MS) {
+            return;
+        }
+    }
+    history_[history_head_] = {now_ms, percent_x10_};
+    history_head_ = (history_head_ + 1) % BATTERY_EST_HISTORY;
+    if (history_count_ < BATTERY_EST_HISTORY) {
+        ++history_count_;
+    }
+}
+
+uint32_t BatteryEstimator::runtime_from_history() const {
+    if (history_count_ < 2) {
+        return BATTERY_EST_RUNTIME_UNKNOWN;
+    }
+    const uint8_t oldest = (history_count_ < BATTERY_EST_HISTORY) ? 0 : history_head_;
+    const uint8_t newest = (history_head_ + BATTERY_EST_HISTORY - 1) % BATTERY_EST_HISTORY;
+    const DrainPoint &a = history_[oldest];
+    const DrainPoint &b = history_[newest];
+    const uint32_t window_ms = b.time_ms - a.time_ms;
+    // Rising or flat: charging or idle, no meaningful runtime.
+    if (window_ms < kMinRuntimeWindowMs || b.percent_x10 + kMinDrainX10 > a.percent_x10) {
+        return BATTERY_EST_RUNTIME_UNKNOWN;
+    }
+    const uint32_t drained_x10 = a.percent_x10 - b.percent_x10;
+    // runtime = remaining / (drained / window)
+    return static_cast<uint32_t>((static_cast<uint64_t>(b.percent_x10) * window_ms) / drained_x10 / 60000ULL);
+}
+
+bool BatteryEstimator::worth_publishing() const {
+    if (!has_published_) {
+        return true;
+    }
+    if (current_.state != published_.state) {
+        return true;
+    }
+    const int percent_delta = static_cast<int>(current_.percent) - published_.percent;
+    if (percent_delta >= kPercentStep || percent_delta <= -kPercentStep) {
+        return true;
+    }
+    const bool was_known = published_.runtime_min != BATTERY_EST_RUNTIME_UNKNOWN;
+    const bool is_known = current_.runtime_min != BATTERY_EST_RUNTIME_UNKNOWN;
+    if (was_known != is_known) {
+        return true;
+    }
+    if (is_known) {
+        const uint32_t a = current_.runtime_min;
+        const uint32_t b = published_.runtime_min;
+        const uint32_t delta = (a > b) ? a - b : b - a;
+        // At least 5 min and 10% of the value.
+        return delta >= kRuntimeStepMin && delta * 10 >= b;
+    }
+    return false;
+}
+
+bool BatteryEstimator::push_burst(const uint16_t *millivolts, size_t count, uint32_t now_ms) {
+    if (!millivolts || count == 0) {
+        return false;
+    }
+
+    const uint16_t burst_mv = reject_sag(millivolts, count);
+    if (!primed_) {
+        filtered_mv_x16_ = static_cast<uint32_t>(burst_mv) << 4;
+        primed_ = true;
+    } else {
+        const int32_t target = static_cast<int32_t>(burst_mv) << 4;
+        filtered_mv_x16_ = static_cast<uint32_t>(static_cast<int32_t>(filtered_mv_x16_) +
+                                                 ((target - static_cast<int32_t>(filtered_mv_x16_)) >> kEmaShift));
+    }
+
+    current_.millivolts = static_cast<uint16_t>((filtered_mv_x16_ + 8) >> 4);
+    percent_x10_ = percent_x10_from_mv(current_.millivolts);
+    current_.percent = static_cast<uint8_t>((percent_x10_ + 5) / 10);
+    current_.state = state_for_percent(current_.percent);
+    record_history(now_ms);
+    current_.runtime_min = runtime_from_history();
+
+    if (!worth_publishing()) {
+        return false;
+    }
+    published_ = current_;
+    has_published_ = true;
+    return true;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+constexpr uint8_t BATTERY_EST_MAX_BURST = 32;
+// Drain history: one point per BATTERY_EST_HISTORY_STEP_MS, oldest overwritten.
+constexpr uint8_t BATTERY_EST_HISTORY = 32;
+constexpr uint32_t BATTERY_EST_HISTORY_STEP_MS = 60000;
+constexpr uint32_t BATTERY_EST_RUNTIME_UNKNOWN = UINT32_MAX;
+
+struct BatteryEstimate {
+    // Filtered cell voltage.
+    uint16_t millivolts;
+    uint8_t percent;
+    // 0..4, the five icon steps.
+    uint8_t state;
+    // From the drain over the history window; unknown while charging, flat or still learning.
+    uint32_t runtime_min;
+};
+
+// Battery state-of-charge estimator. Each ADC burst is reduced to the mean of its upper half,
+// which drops the dips caused by RF and amplifier load, then smoothed with an EMA, mapped to
+// percent through a Li-ion discharge LUT, and turned into a runtime from the recent drain.
+// Plain C++: feed recorded millivolt traces on the host.
+class BatteryEstimator {
+public:
+    void reset();
+
+    // One oversampled burst taken at now_ms. Returns true when the estimate moved enough to be
+    // worth publishing (icon step, percent step, or runtime).
+    bool push_burst(const uint16_t *millivolts, size_t count, uint32_t now_ms);
+
+    const BatteryEstimate &estimate() const {
+        return published_;
+    }
+    // Latest values, including changes too small to publish.
+    const BatteryEstimate &current() const {
+        return current_;
+    }
+
+    static uint16_t percent_x10_from_mv(uint16_t millivolts);
+
+private:
+    struct DrainPoint {
+        uint32_t time_ms;
+        uint16_t percent_x10;
+    };
+
+    uint16_t reject_sag(const uint16_t *millivolts, size_t count) const;
+    uint8_t state_for_percent(uint8_t percent) const;
+    uint32_t runtime_from_history() const;
+    void record_history(uint32_t now_ms);
+    bool worth_publishing() const;
+
+    bool primed_ = false;
+    // EMA state, mV scaled by 16.
+    uint32_t filtered_mv_x16_ = 0;
+    uint16_t percent_x10_ = 0;
+    BatteryEstimate current_ = {};
+    BatteryEstimate published_ = {};
+    bool has_published_ = false;
+
+    DrainPoint history_[BATTERY_EST_HISTORY] = {};
+    uint8_t history_head_ = 0;
+    uint8_t history_count_ = 0;
+};
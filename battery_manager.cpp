@@ -10,45 +10,55 @@ namespace {
 
 constexpr uint32_t BATTERY_START_DELAY_MS = 5000;
 constexpr uint32_t BATTERY_POLL_MS = 10000;
+constexpr size_t BATTERY_BURST_SAMPLES = 16;
+constexpr uint32_t BATTERY_BURST_SPACING_MS = 2;
+static_assert(BATTERY_BURST_SAMPLES <= BATTERY_EST_MAX_BURST, "burst larger than the estimator accepts");
 
 BatteryUpdateCb battery_update_cb = nullptr;
 TaskHandle_t battery_task_handle = nullptr;
 bool battery_manager_ready = false;
 
-uint8_t battery_state_from_voltage(float voltage) {
-    if (voltage >= 4.10f) {
-        return 4;
-    }
-    if (voltage >= 3.95f) {
-        return 3;
-    }
-    if (voltage >= 3.80f) {
-        return 2;
-    }
-    if (voltage >= 3.60f) {
-        return 1;
+BatteryEstimator battery_estimator;
+
+// Oversampled burst: spread over a few ms so one RF or audio load spike hits only some samples.
+void sample_burst(uint16_t *millivolts, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        float voltage = 0.0f;
+        int raw = 0;
+        adc_get_value(&voltage, &raw);
+        millivolts[i] = static_cast<uint16_t>(voltage * 1000.0f + 0.5f);
+        if (i + 1 < count) {
+            vTaskDelay(pdMS_TO_TICKS(BATTERY_BURST_SPACING_MS));
+        }
     }
-    return 0;
 }
 
 void battery_task(void *param) {
     (void)param;
 
-    uint8_t last_state = 255;
     vTaskDelay(pdMS_TO_TICKS(BATTERY_START_DELAY_MS));
 
+    uint16_t burst[BATTERY_BURST_SAMPLES];
     while (true) {
-        float voltage = 0.0f;
-        int raw = 0;
-        adc_get_value(&voltage, &raw);
-
-        const uint8_t state = battery_state_from_voltage(voltage);
-        if (state != last_state) {
-            last_state = state;
+        sample_burst(burst, BATTERY_BURST_SAMPLES);
+        if (battery_estimator.push_burst(burst, BATTERY_BURST_SAMPLES, millis())) {
+            const BatteryEstimate &estimate = battery_estimator.estimate();
             if (battery_update_cb) {
-                battery_update_cb(state, voltage);
+                battery_update_cb(estimate);
+            }
+            if (estimate.runtime_min == BATTERY_EST_RUNTIME_UNKNOWN) {
+                Serial.printf("[BAT] vbat=%umV %u%% state=%u autonomie=?\n",
+                              estimate.millivolts,
+                              estimate.percent,
+                              estimate.state);
+            } else {
+                Serial.printf("[BAT] vbat=%umV %u%% state=%u autonomie=%luh%02lu\n",
+                              estimate.millivolts,
+                              estimate.percent,
+                              estimate.state,
+                              static_cast<unsigned long>(estimate.runtime_min / 60),
+                              static_cast<unsigned long>(estimate.runtime_min % 60));
             }
-            Serial.printf("[BAT] raw=%d vbat=%.2fV state=%u\n", raw, voltage, state);
         }
 
         vTaskDelay(pdMS_TO_TICKS(BATTERY_POLL_MS));
@@ -1,7 +1,10 @@
 #pragma once
 
+#include "battery_estimator.h"
+
 #include <stdint.h>
 
-typedef void (*BatteryUpdateCb)(uint8_t battery_state, float battery_voltage);
+// Called from the battery task only when the estimate moved meaningfully.
+typedef void (*BatteryUpdateCb)(const BatteryEstimate &estimate);
 
 void battery_manager_init(BatteryUpdateCb on_battery_update);
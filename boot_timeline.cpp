@@ -0,0 +1,64 @@
+#include "boot_timeline.h"
+
+#include <Arduino.h>
+
+namespace {
+
+const char *const kPhaseNames[BOOT_PHASE_COUNT] = {
+    "setup",
+    "config NVS",
+    "radio CC1101",
+    "codec audio",
+    "batterie ADC",
+    "UI LVGL",
+    "fin splash",
+    "premier scan",
+};
+
+// Single 32-bit stores: each slot is written once by whichever task reaches the phase.
+volatile uint32_t g_phase_us[BOOT_PHASE_COUNT] = {};
+portMUX_TYPE g_timeline_mux = portMUX_INITIALIZER_UNLOCKED;
+bool g_printed = false;
+
+}  // namespace
+
+void boot_timeline_mark(BootPhase phase) {
+    if (phase >= BOOT_PHASE_COUNT) {
+        return;
+    }
+    // micros() is never 0 once setup() runs, so 0 means "not reached".
+    const uint32_t now_us = micros();
+    portENTER_CRITICAL(&g_timeline_mux);
+    if (g_phase_us[phase] == 0) {
+        g_phase_us[phase] = now_us;
+    }
+    portEXIT_CRITICAL(&g_timeline_mux);
+}
+
+uint32_t boot_timeline_get_us(BootPhase phase) {
+    return (phase < BOOT_PHASE_COUNT) ? g_phase_us[phase] : 0;
+}
+
+void boot_timeline_print_once() {
+    portENTER_CRITICAL(&g_timeline_mux);
+    const bool already = g_printed;
+    g_printed = true;
+    portEXIT_CRITICAL(&g_timeline_mux);
+    if (already) {
+        return;
+    }
+
+    const uint32_t setup_us = g_phase_us[BOOT_PHASE_SETUP];
+    Serial.println("[BOOT] Chronologie (depuis reset | depuis setup):");
+    for (uint8_t i = 0; i < BOOT_PHASE_COUNT; ++i) {
+        const uint32_t t_us = g_phase_us[i];
+        if (t_us == 0) {
+            Serial.printf("[BOOT] %-14s ---\n", kPhaseNames[i]);
+            continue;
+        }
+        Serial.printf("[BOOT] %-14s %7lu ms | +%lu ms\n",
+                      kPhaseNames[i],
+                      static_cast<unsigned long>(t_us / 1000),
+                      static_cast<unsigned long>((t_us - setup_us) / 1000));
+    }
+}
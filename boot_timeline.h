@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdint.h>
+
+// Boot milestones, reached from different tasks and cores.
+enum BootPhase : uint8_t {
+    BOOT_PHASE_SETUP = 0,
+    BOOT_PHASE_CONFIG,
+    BOOT_PHASE_RADIO,
+    BOOT_PHASE_CODEC,
+    BOOT_PHASE_BATTERY,
+    BOOT_PHASE_UI,
+    BOOT_PHASE_SPLASH_DONE,
+    BOOT_PHASE_FIRST_SCAN,
+    BOOT_PHASE_COUNT,
+};
+
+// Records micros() the first time a phase is reached; later calls are ignored.
+void boot_timeline_mark(BootPhase phase);
+// 0 while the phase has not been reached.
+uint32_t boot_timeline_get_us(BootPhase phase);
+// Prints every reached phase relative to reset and to setup(), once per boot.
+void boot_timeline_print_once();
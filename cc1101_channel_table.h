@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// CC1101 reference crystal (Waveshare module uses a 26 MHz XOSC).
+constexpr uint32_t CC1101_XOSC_HZ = 26000000;
+
+// Precomputed FREQ2/FREQ1/FREQ0 triplet for one carrier frequency.
+struct Cc1101FreqWord {
+    uint32_t frequency_hz;
+    uint8_t freq2;
+    uint8_t freq1;
+    uint8_t freq0;
+};
+
+// Datasheet formula: f_carrier = fXOSC / 2^16 * FREQ[23:0], rounded to nearest step.
+constexpr uint32_t cc1101_freq_reg_value(uint32_t frequency_hz) {
+    return static_cast<uint32_t>(((static_cast<uint64_t>(frequency_hz) << 16) + CC1101_XOSC_HZ / 2) /
+                                 CC1101_XOSC_HZ);
+}
+
+constexpr Cc1101FreqWord cc1101_make_freq_word(uint32_t frequency_hz) {
+    const uint32_t value = cc1101_freq_reg_value(frequency_hz);
+    return Cc1101FreqWord{
+        frequency_hz,
+        static_cast<uint8_t>((value >> 16) & 0xFF),
+        static_cast<uint8_t>((value >> 8) & 0xFF),
+        static_cast<uint8_t>(value & 0xFF),
+    };
+}
+
+// Known sub-GHz remote/ISM channels visited by the coarse scan.
+constexpr uint32_t kSubGHzFrequencyList[] = {
+    300000000, 302757000, 303875000, 303900000, 304250000,
+    307000000, 307500000, 307800000, 309000000, 310000000,
+    312000000, 312100000, 312200000, 313000000, 313850000,
+    314000000, 314350000, 314980000, 315000000, 318000000,
+    330000000, 345000000, 348000000, 350000000, 387000000,
+    390000000, 418000000, 430000000, 430500000, 431000000,
+    431500000, 433075000, 433220000, 433420000, 433657070,
+    433889000, 433920000, 434075000, 434176948, 434190000,
+    434390000, 434420000, 434620000, 434775000, 438900000,
+    440175000, 464000000, 467750000, 779000000, 868350000,
+    868400000, 868800000, 868950000, 906400000, 915000000,
+    925000000, 928000000
+};
+
+constexpr size_t kSubGHzChannelCount = sizeof(kSubGHzFrequencyList) / sizeof(kSubGHzFrequencyList[0]);
+
+template <size_t N>
+struct Cc1101ChannelTable {
+    Cc1101FreqWord words[N];
+
+    constexpr const Cc1101FreqWord &operator[](size_t index) const {
+        return words[index];
+    }
+
+    constexpr size_t size() const {
+        return N;
+    }
+};
+
+template <size_t N>
+constexpr Cc1101ChannelTable<N> cc1101_make_channel_table(const uint32_t (&frequencies_hz)[N]) {
+    Cc1101ChannelTable<N> table{};
+    for (size_t i = 0; i < N; ++i) {
+        table.words[i] = cc1101_make_freq_word(frequencies_hz[i]);
+    }
+    return table;
+}
+
+// Generated at compile time: the scan loop only pushes these bytes over SPI.
+constexpr Cc1101ChannelTable<kSubGHzChannelCount> kSubGHzChannelTable =
+    cc1101_make_channel_table(kSubGHzFrequencyList);
+
+// Spot checks against hand-computed datasheet values.
+static_assert(cc1101_freq_reg_value(433920000) == 0x10B071, "433.92 MHz FREQ word");
+static_assert(cc1101_freq_reg_value(868350000) == 0x2165E8, "868.35 MHz FREQ word");
+static_assert(kSubGHzChannelTable[0].freq2 == 0x0B &&
+              kSubGHzChannelTable[0].freq1 == 0x89 &&
+              kSubGHzChannelTable[0].freq0 == 0xD9,
+              "300 MHz FREQ2/FREQ1/FREQ0");
+static_assert(kSubGHzChannelTable[kSubGHzChannelCount - 1].frequency_hz == 928000000,
+              "table follows kSubGHzFrequencyList order");
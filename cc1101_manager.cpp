@@ -1,8 +1,16 @@
 #include "cc1101_manager.h"
 
+#include "cc1101_channel_table.h"
+#include "channel_scheduler.h"
+#include "emitter_cache.h"
+#include "energy_accounting.h"
+#include "modulation_classifier.h"
+#include "noise_floor_tracker.h"
+
 #include <Arduino.h>
 #include <RadioLib.h>
 #include <SPI.h>
+#include <string.h>
 
 namespace {
 
@@ -15,33 +23,131 @@ constexpr int CC1101_SCK = 41;
 
 struct FrequencyRSSI {
     uint32_t frequency_coarse;
+    size_t channel_coarse;
     int rssi_coarse;
     uint32_t frequency_fine;
     int rssi_fine;
     bool is_fsk;
 };
 
-static const uint32_t kSubGHzFrequencyList[] = {
-    300000000, 302757000, 303875000, 303900000, 304250000,
-    307000000, 307500000, 307800000, 309000000, 310000000,
-    312000000, 312100000, 312200000, 313000000, 313850000,
-    314000000, 314350000, 314980000, 315000000, 318000000,
-    330000000, 345000000, 348000000, 350000000, 387000000,
-    390000000, 418000000, 430000000, 430500000, 431000000,
-    431500000, 433075000, 433220000, 433420000, 433657070,
-    433889000, 433920000, 434075000, 434176948, 434190000,
-    434390000, 434420000, 434620000, 434775000, 438900000,
-    440175000, 464000000, 467750000, 779000000, 868350000,
-    868400000, 868800000, 868950000, 906400000, 915000000,
-    925000000, 928000000
+// RadioLib keeps its raw SPI helpers protected; expose them for register fast paths.
+class Cc1101Radio : public CC1101 {
+public:
+    using CC1101::CC1101;
+    using CC1101::SPIreadRegister;
+    using CC1101::SPIreadRegisterBurst;
+    using CC1101::SPIsendCommand;
+    using CC1101::SPIsetRegValue;
+    using CC1101::SPIwriteRegisterBurst;
+};
+
+// FSCAL3/FSCAL2/FSCAL1 captured after one synthesizer calibration.
+struct Cc1101CalWord {
+    uint8_t fscal3;
+    uint8_t fscal2;
+    uint8_t fscal1;
+};
+
+// Sweep points are calibrated lazily, keyed by the exact sweep plan.
+// Conditions a calibration cache was built under, checked for drift.
+struct CalStamp {
+    float temp_c;
+    uint32_t time_ms;
+};
+
+struct SweepCalCache {
+    bool valid;
+    CalStamp stamp;
+    uint32_t start_hz;
+    uint32_t step_hz;
+    uint16_t sample_count;
+    Cc1101CalWord cal[CC1101_SWEEP_MAX_SAMPLES];
+};
+
+// Radio profiles stored as full config register images (0x00..TEST0).
+enum RadioProfile : uint8_t {
+    PROFILE_SCAN = 0,
+    PROFILE_FINE,
+    PROFILE_SWEEP,
+    PROFILE_OOK_LOW,
+    PROFILE_OOK_HIGH,
+    PROFILE_COUNT,
+};
+
+constexpr uint8_t kConfigRegCount = RADIOLIB_CC1101_REG_TEST0 + 1;
+
+struct Cc1101RegisterImage {
+    uint8_t regs[kConfigRegCount];
 };
 
+constexpr uint8_t kMarcStateIdle = 0x01;
+constexpr uint8_t kMarcStateRx = 0x0D;
+constexpr uint32_t kCalTimeoutUs = 2000;
+// A manual calibration lasts about 720 us; MARCSTATE leaving IDLE well before that proves
+// the SCAL strobe was taken.
+constexpr uint32_t kCalStartTimeoutUs = 500;
+// Recalibrate when the die temperature moved this much since the last calibration.
+constexpr float kCalMaxTempDriftC = 8.0f;
+constexpr uint32_t kCalMaxAgeMs = 10UL * 60UL * 1000UL;
+constexpr uint32_t kCalTempCheckIntervalMs = 10000;
+
+// RSSI settles once the AGC averaged a few windows of 8 * 2^FILTER_LENGTH channel filter samples.
+constexpr uint32_t kRssiSettleWindows = 4;
+constexpr uint32_t kRssiMinSettleUs = 50;
+// Upper bounds match the previous fixed dwell, so the adaptive path is never slower.
+constexpr uint32_t kRssiMaxSettleUs = 3000;
+constexpr uint32_t kRxStartTimeoutUs = 1000;
+constexpr int kRssiOffsetDb = 74;
+constexpr int kDwellReportEveryScans = 500;
+// Fine search: +-300 kHz stays within the coarse channel calibration.
+constexpr uint32_t kFineHalfSpanHz = 300000;
+constexpr uint32_t kFineResolutionHz = 20000;
+// Modulation is classified from the RSSI envelope over one dwell: ~10 OOK symbols of a typical remote.
+constexpr uint16_t kModulationSamples = 64;
+constexpr uint32_t kModulationDwellUs = 4000;
+// Sweep peaks must stand this far above the sweep mean, and this many bins apart.
+constexpr int kSweepPeakMarginDb = 6;
+constexpr uint16_t kSweepPeakMinSeparation = 2;
+constexpr int kDefaultNoiseMarginDb = 10;
+// Coarse frame: as many dwells as a uniform pass; a third of them walk all channels,
+// so every channel is revisited within 3 frames whatever the weights.
+constexpr uint16_t kScheduleSlotsPerFrame = kSubGHzChannelCount;
+constexpr uint16_t kScheduleGuaranteedSlots = (kSubGHzChannelCount + 2) / 3;
+// Channels pinned at boot: the busiest remote bands.
+constexpr uint32_t kDefaultPinnedHz[] = {433920000, 868350000};
+
 SPIClass spiCC1101(FSPI);
-CC1101 cc1101 = new Module(CC1101_CS, CC1101_GDO0, RADIOLIB_NC, RADIOLIB_NC, spiCC1101);
+Cc1101Radio cc1101(new Module(CC1101_CS, CC1101_GDO0, RADIOLIB_NC, RADIOLIB_NC, spiCC1101));
 int g_scan_count = 0;
 // Set when spectrum mode was active and scan profile must be fully restored.
 bool g_need_scan_reinit = false;
 
+Cc1101CalWord g_channel_cal[kSubGHzChannelCount] = {};
+bool g_channel_cal_valid = false;
+CalStamp g_channel_cal_stamp = {};
+SweepCalCache g_sweep_cal = {};
+uint32_t g_cal_temp_check_ms = 0;
+
+// Shadow of the chip register file; every profile write goes through it.
+Cc1101RegisterImage g_shadow = {};
+Cc1101RegisterImage g_profiles[PROFILE_COUNT] = {};
+RadioProfile g_active_profile = PROFILE_COUNT;
+
+uint32_t g_rssi_settle_us = kRssiMaxSettleUs;
+Cc1101DwellStats g_channel_dwell[kSubGHzChannelCount] = {};
+Cc1101DwellStats g_fine_dwell = {};
+FreqRefineStrategy g_refine_strategy = FREQ_REFINE_GOLDEN_SECTION;
+Cc1101DwellStats g_sweep_dwell = {};
+
+// Per-channel noise floor, fed by every coarse reading.
+NoiseFloorCell g_noise_cells[kSubGHzChannelCount] = {};
+NoiseFloorTracker g_noise_floor;
+bool g_relative_threshold = false;
+int g_noise_margin_db = kDefaultNoiseMarginDb;
+ChannelScheduler g_scheduler;
+// Refined emitters per coarse channel: repeat hits skip the fine search and modulation dwell.
+EmitterCache g_emitters;
+
 float clamp_freq(float value_mhz, float min_mhz, float max_mhz) {
     if (value_mhz < min_mhz) {
         return min_mhz;
@@ -52,66 +158,387 @@ float clamp_freq(float value_mhz, float min_mhz, float max_mhz) {
     return value_mhz;
 }
 
-void apply_scan_profile() {
-    // Wide bandwidth scan profile for fast coarse detection.
+void write_freq_word(const Cc1101FreqWord &word) {
+    uint8_t regs[3] = {word.freq2, word.freq1, word.freq0};
+    cc1101.SPIwriteRegisterBurst(RADIOLIB_CC1101_REG_FREQ2, regs, sizeof(regs));
+}
+
+void write_fscal(const Cc1101CalWord &cal) {
+    uint8_t regs[3] = {cal.fscal3, cal.fscal2, cal.fscal1};
+    cc1101.SPIwriteRegisterBurst(RADIOLIB_CC1101_REG_FSCAL3, regs, sizeof(regs));
+}
+
+// Fast-hopping mode needs FS_AUTOCAL=never, otherwise every IDLE->RX recalibrates.
+void disable_autocal() {
+    cc1101.SPIsetRegValue(RADIOLIB_CC1101_REG_MCSM0, RADIOLIB_CC1101_FS_AUTOCAL_NEVER, 5, 4);
+}
+
+// Manual SCAL on one frequency, then read back the resulting FSCAL3..FSCAL1.
+bool calibrate(const Cc1101FreqWord &word, Cc1101CalWord *out_cal) {
+    cc1101.SPIsendCommand(RADIOLIB_CC1101_CMD_IDLE);
+    energy_accounting_set_level(ENERGY_RAIL_RADIO, ENERGY_LEVEL_OFF);
+    write_freq_word(word);
+    cc1101.SPIsendCommand(RADIOLIB_CC1101_CMD_CAL);
+
+    // MARCSTATE can still read IDLE right after the strobe: wait for the calibration to
+    // start before waiting for it to end, or FSCAL is read from the previous calibration.
+    const uint32_t start_us = micros();
+    while ((cc1101.SPIreadRegister(RADIOLIB_CC1101_REG_MARCSTATE) & 0x1F) == kMarcStateIdle) {
+        if (micros() - start_us > kCalStartTimeoutUs) {
+            return false;
+        }
+    }
+    while ((cc1101.SPIreadRegister(RADIOLIB_CC1101_REG_MARCSTATE) & 0x1F) != kMarcStateIdle) {
+        if (micros() - start_us > kCalTimeoutUs) {
+            return false;
+        }
+    }
+
+    uint8_t regs[3] = {0};
+    cc1101.SPIreadRegisterBurst(RADIOLIB_CC1101_REG_FSCAL3, sizeof(regs), regs);
+    out_cal->fscal3 = regs[0];
+    out_cal->fscal2 = regs[1];
+    out_cal->fscal1 = regs[2];
+    return true;
+}
+
+// Retune without RadioLib float/range handling or calibration: IDLE, FREQ and FSCAL bursts, back to RX.
+// Direct RX mode settings come with the active profile image.
+void fast_retune(const Cc1101FreqWord &word, const Cc1101CalWord &cal) {
+    cc1101.SPIsendCommand(RADIOLIB_CC1101_CMD_IDLE);
+    write_freq_word(word);
+    write_fscal(cal);
+    cc1101.SPIsendCommand(RADIOLIB_CC1101_CMD_RX);
+    energy_accounting_set_level(ENERGY_RAIL_RADIO, ENERGY_LEVEL_FULL);
+}
+
+// Minimum RSSI settle time derived from the active RX bandwidth (MDMCFG4) and AGC filter length (AGCCTRL0).
+void update_rssi_settle_time() {
+    const uint8_t mdmcfg4 = g_shadow.regs[RADIOLIB_CC1101_REG_MDMCFG4];
+    const uint8_t agcctrl0 = g_shadow.regs[RADIOLIB_CC1101_REG_AGCCTRL0];
+
+    const uint32_t chanbw_e = (mdmcfg4 >> 6) & 0x03;
+    const uint32_t chanbw_m = (mdmcfg4 >> 4) & 0x03;
+    const uint32_t bw_hz = CC1101_XOSC_HZ / (8 * (4 + chanbw_m) * (1UL << chanbw_e));
+    const uint32_t filter_samples = 8UL << (agcctrl0 & 0x03);
+
+    uint32_t settle_us = (kRssiSettleWindows * filter_samples * 1000000UL) / bw_hz;
+    if (settle_us < kRssiMinSettleUs) {
+        settle_us = kRssiMinSettleUs;
+    } else if (settle_us > kRssiMaxSettleUs) {
+        settle_us = kRssiMaxSettleUs;
+    }
+    g_rssi_settle_us = settle_us;
+}
+
+void record_dwell(Cc1101DwellStats *stats, uint32_t dwell_us) {
+    if (stats->samples == 0 || dwell_us < stats->min_us) {
+        stats->min_us = dwell_us;
+    }
+    if (dwell_us > stats->max_us) {
+        stats->max_us = dwell_us;
+    }
+    stats->last_us = dwell_us;
+    stats->total_us += dwell_us;
+    stats->samples++;
+}
+
+// RSSI status register in dBm (datasheet 17.3: two's complement, 0.5 dB steps, minus offset).
+int read_rssi_dbm() {
+    const uint8_t raw = cc1101.SPIreadRegister(RADIOLIB_CC1101_REG_RSSI);
+    const int rssi_dec = (raw >= 128) ? static_cast<int>(raw) - 256 : static_cast<int>(raw);
+    return rssi_dec / 2 - kRssiOffsetDb;
+}
+
+// Dwell right after the RX strobe: wait for MARCSTATE=RX (PLL locked), then the AGC settle time.
+// The CC1101 has no RSSI-valid flag (CS only asserts above threshold), so the window is computed.
+int dwell_and_read_rssi(Cc1101DwellStats *stats) {
+    const uint32_t start_us = micros();
+    while ((cc1101.SPIreadRegister(RADIOLIB_CC1101_REG_MARCSTATE) & 0x1F) != kMarcStateRx) {
+        if (micros() - start_us > kRxStartTimeoutUs) {
+            break;
+        }
+    }
+    delayMicroseconds(g_rssi_settle_us);
+
+    const int rssi = read_rssi_dbm();
+    record_dwell(stats, micros() - start_us);
+    return rssi;
+}
+
+void invalidate_calibration() {
+    g_channel_cal_valid = false;
+    g_sweep_cal.valid = false;
+}
+
+bool calibrate_channels() {
+    const uint32_t start_us = micros();
+    for (size_t i = 0; i < kSubGHzChannelCount; ++i) {
+        if (!calibrate(kSubGHzChannelTable[i], &g_channel_cal[i])) {
+            Serial.printf("[CC1101] calibration timeout @ %.3f MHz\n", kSubGHzChannelTable[i].frequency_hz / 1e6);
+            g_channel_cal_valid = false;
+            return false;
+        }
+    }
+
+    g_channel_cal_valid = true;
+    g_channel_cal_stamp = {temperatureRead(), millis()};
+    Serial.printf("[CC1101] FSCAL cache: %u canaux en %lu us (%.1f C)\n",
+                  static_cast<unsigned>(kSubGHzChannelCount),
+                  static_cast<unsigned long>(micros() - start_us),
+                  g_channel_cal_stamp.temp_c);
+    return true;
+}
+
+bool cal_stamp_drifted(const CalStamp &stamp, float temp_c, uint32_t now_ms) {
+    return fabsf(temp_c - stamp.temp_c) >= kCalMaxTempDriftC || (now_ms - stamp.time_ms) >= kCalMaxAgeMs;
+}
+
+// Drop each cached calibration once temperature drifted or the cache got old, against the
+// conditions that cache was built under: channel and sweep caches are rebuilt separately.
+void check_calibration_drift() {
+    const uint32_t now_ms = millis();
+    if ((!g_channel_cal_valid && !g_sweep_cal.valid) || (now_ms - g_cal_temp_check_ms) < kCalTempCheckIntervalMs) {
+        return;
+    }
+    g_cal_temp_check_ms = now_ms;
+
+    const float temp_c = temperatureRead();
+    if (g_channel_cal_valid && cal_stamp_drifted(g_channel_cal_stamp, temp_c, now_ms)) {
+        Serial.printf("[CC1101] FSCAL canaux invalide (%.1f C -> %.1f C)\n", g_channel_cal_stamp.temp_c, temp_c);
+        g_channel_cal_valid = false;
+    }
+    if (g_sweep_cal.valid && cal_stamp_drifted(g_sweep_cal.stamp, temp_c, now_ms)) {
+        Serial.printf("[CC1101] FSCAL balayage invalide (%.1f C -> %.1f C)\n", g_sweep_cal.stamp.temp_c, temp_c);
+        g_sweep_cal.valid = false;
+    }
+}
+
+bool ensure_channel_calibration() {
+    check_calibration_drift();
+    if (g_channel_cal_valid) {
+        return true;
+    }
+    return calibrate_channels();
+}
+
+bool ensure_sweep_calibration(uint32_t start_hz, uint32_t step_hz, uint16_t sample_count) {
+    check_calibration_drift();
+    if (g_sweep_cal.valid &&
+        g_sweep_cal.start_hz == start_hz &&
+        g_sweep_cal.step_hz == step_hz &&
+        g_sweep_cal.sample_count == sample_count) {
+        return true;
+    }
+
+    g_sweep_cal.valid = false;
+    for (uint16_t i = 0; i < sample_count; ++i) {
+        const Cc1101FreqWord word = cc1101_make_freq_word(start_hz + step_hz * i);
+        if (!calibrate(word, &g_sweep_cal.cal[i])) {
+            return false;
+        }
+    }
+
+    g_sweep_cal.start_hz = start_hz;
+    g_sweep_cal.step_hz = step_hz;
+    g_sweep_cal.sample_count = sample_count;
+    g_sweep_cal.stamp = {temperatureRead(), millis()};
+    g_sweep_cal.valid = true;
+    return true;
+}
+
+// Builds a profile through RadioLib on top of the scan base settings. Only used while capturing images.
+void build_profile_with_radiolib(RadioProfile profile) {
     cc1101.standby();
+    energy_accounting_set_level(ENERGY_RAIL_RADIO, ENERGY_LEVEL_OFF);
     cc1101.setOOK(false);
     cc1101.setRxBandwidth(650);
     cc1101.setFrequencyDeviation(47.6);
     cc1101.setFrequency(433.92);
+
+    switch (profile) {
+        case PROFILE_SCAN:
+            // Wide bandwidth scan profile for fast coarse detection.
+            break;
+        case PROFILE_FINE:
+            cc1101.setRxBandwidth(58);
+            break;
+        case PROFILE_SWEEP:
+            // Narrower profile used for spectrum bars around one band.
+            cc1101.setRxBandwidth(200);
+            break;
+        case PROFILE_OOK_LOW:
+            cc1101.setOOK(true);
+            cc1101.setRxBandwidth(200);
+            break;
+        case PROFILE_OOK_HIGH:
+            cc1101.setOOK(true);
+            cc1101.setRxBandwidth(250);
+            break;
+        default:
+            break;
+    }
+    // Direct mode settings (GDO0 async data, infinite length) become part of every image.
+    cc1101.receiveDirect();
+    cc1101.SPIsendCommand(RADIOLIB_CC1101_CMD_IDLE);
+    energy_accounting_set_level(ENERGY_RAIL_RADIO, ENERGY_LEVEL_OFF);
+}
+
+void read_register_image(Cc1101RegisterImage *out_image) {
+    cc1101.SPIreadRegisterBurst(0x00, kConfigRegCount, out_image->regs);
+}
+
+// FREQ and FSCAL are owned by the hop path, profiles never touch them.
+bool is_hop_register(uint8_t reg) {
+    return (reg >= RADIOLIB_CC1101_REG_FREQ2 && reg <= RADIOLIB_CC1101_REG_FREQ2 + 2) ||
+           (reg >= RADIOLIB_CC1101_REG_FSCAL3 && reg <= RADIOLIB_CC1101_REG_FSCAL3 + 3);
+}
+
+size_t count_register_mismatches(const Cc1101RegisterImage &a, const Cc1101RegisterImage &b) {
+    size_t mismatches = 0;
+    for (uint8_t reg = 0; reg < kConfigRegCount; ++reg) {
+        if (!is_hop_register(reg) && a.regs[reg] != b.regs[reg]) {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+// Burst-write only the runs of registers that differ from the shadow.
+size_t write_register_diff(const Cc1101RegisterImage &target) {
+    size_t written = 0;
+    uint8_t reg = 0;
+    while (reg < kConfigRegCount) {
+        if (is_hop_register(reg) || target.regs[reg] == g_shadow.regs[reg]) {
+            reg++;
+            continue;
+        }
+
+        const uint8_t run_start = reg;
+        while (reg < kConfigRegCount && !is_hop_register(reg) && target.regs[reg] != g_shadow.regs[reg]) {
+            g_shadow.regs[reg] = target.regs[reg];
+            reg++;
+        }
+        cc1101.SPIwriteRegisterBurst(run_start, &g_shadow.regs[run_start], reg - run_start);
+        written += reg - run_start;
+    }
+    return written;
+}
+
+void switch_profile(RadioProfile profile) {
+    if (profile == g_active_profile) {
+        return;
+    }
+    cc1101.SPIsendCommand(RADIOLIB_CC1101_CMD_IDLE);
+    energy_accounting_set_level(ENERGY_RAIL_RADIO, ENERGY_LEVEL_OFF);
+    write_register_diff(g_profiles[profile]);
+    g_active_profile = profile;
+    update_rssi_settle_time();
+}
+
+void apply_scan_profile() {
+    switch_profile(PROFILE_SCAN);
 }
 
 void apply_sweep_profile() {
-    // Narrower profile used for spectrum bars around one band.
-    cc1101.standby();
-    cc1101.setOOK(false);
-    cc1101.setRxBandwidth(200);
+    switch_profile(PROFILE_SWEEP);
 }
 
-bool reinit_for_scan() {
-    // Hard reinit protects against radio state corruption after spectrum sweeps.
+// Capture every profile once through RadioLib, then switch between images with diff-only writes.
+void capture_profiles() {
+    for (int p = PROFILE_COUNT - 1; p >= 0; --p) {
+        build_profile_with_radiolib(static_cast<RadioProfile>(p));
+        read_register_image(&g_profiles[p]);
+    }
+    // PROFILE_SCAN was captured last, so the chip currently holds it.
+    g_shadow = g_profiles[PROFILE_SCAN];
+    g_active_profile = PROFILE_SCAN;
+    update_rssi_settle_time();
+}
+
+// Full begin() is only the fallback when the register file cannot be repaired from the shadow.
+bool hard_reinit() {
     spiCC1101.begin(CC1101_SCK, CC1101_MISO, CC1101_MOSI, CC1101_CS);
     const int state = cc1101.begin();
     if (state != RADIOLIB_ERR_NONE) {
         Serial.printf("[CC1101] scan reinit failed: %d\n", state);
         return false;
     }
+    // begin() restores FS_AUTOCAL and resets the synthesizer, cached FSCAL values are stale.
+    invalidate_calibration();
+    read_register_image(&g_shadow);
+    g_active_profile = PROFILE_COUNT;
     apply_scan_profile();
-    g_need_scan_reinit = false;
     Serial.println("[CC1101] scan reinit OK");
     return true;
 }
 
-bool detect_modulation(float frequency_mhz) {
-    int rssi_ask = -120;
-    int rssi_fsk = -120;
+// Verified readback of the shadow replaces the systematic begin() after spectrum mode.
+bool reinit_for_scan() {
+    cc1101.SPIsendCommand(RADIOLIB_CC1101_CMD_IDLE);
+    energy_accounting_set_level(ENERGY_RAIL_RADIO, ENERGY_LEVEL_OFF);
+    Cc1101RegisterImage readback{};
+    read_register_image(&readback);
+    size_t mismatches = count_register_mismatches(readback, g_shadow);
+
+    if (mismatches != 0) {
+        Serial.printf("[CC1101] shadow: %u registres divergents, reparation\n", static_cast<unsigned>(mismatches));
+        // Adopt the real chip state so the diff rewrites exactly the corrupted registers.
+        g_shadow = readback;
+        g_active_profile = PROFILE_COUNT;
+        invalidate_calibration();
+    }
+    apply_scan_profile();
 
-    const float bandwidth = (frequency_mhz > 850.0f) ? 250.0f : 200.0f;
-    const float deviation = (frequency_mhz > 850.0f) ? 50.0f : 47.6f;
+    if (mismatches != 0) {
+        read_register_image(&readback);
+        mismatches = count_register_mismatches(readback, g_shadow);
+        if (mismatches != 0 && !hard_reinit()) {
+            return false;
+        }
+    }
 
-    // ASK/OOK measurement.
-    cc1101.setOOK(true);
-    cc1101.setFrequency(frequency_mhz);
-    cc1101.setRxBandwidth(bandwidth);
-    cc1101.standby();
-    delay(2);
-    cc1101.receiveDirect();
-    delay(8);
-    rssi_ask = cc1101.getRSSI();
+    g_need_scan_reinit = false;
+    return true;
+}
 
-    // FSK measurement.
-    cc1101.setOOK(false);
-    cc1101.setFrequency(frequency_mhz);
-    cc1101.setRxBandwidth(bandwidth);
-    cc1101.setFrequencyDeviation(deviation);
-    cc1101.standby();
-    delay(2);
-    cc1101.receiveDirect();
-    delay(8);
-    rssi_fsk = cc1101.getRSSI();
+// Fine search probe: ctx is the coarse channel calibration word.
+int fine_probe(uint32_t freq_hz, void *ctx) {
+    fast_retune(cc1101_make_freq_word(freq_hz), *static_cast<const Cc1101CalWord *>(ctx));
+    return dwell_and_read_rssi(&g_fine_dwell);
+}
 
-    Serial.printf("    [Modulation] ASK RSSI: %d dBm | FSK RSSI: %d dBm\n", rssi_ask, rssi_fsk);
-    return (rssi_fsk > rssi_ask);
+// Single dwell on the wider OOK profile: sample the RSSI envelope at a fixed rate and classify it.
+// OOK profile of the word's band, tuned to it: the state frame capture expects after a hit.
+void tune_ook(const Cc1101FreqWord &word, const Cc1101CalWord &cal) {
+    const bool high_band = (word.frequency_hz > 850000000UL);
+    switch_profile(high_band ? PROFILE_OOK_HIGH : PROFILE_OOK_LOW);
+    fast_retune(word, cal);
+}
+
+ModulationDecision detect_modulation(const Cc1101FreqWord &word, const Cc1101CalWord &cal, int floor_dbm) {
+    tune_ook(word, cal);
+    dwell_and_read_rssi(&g_fine_dwell);
+
+    int16_t samples[kModulationSamples];
+    constexpr uint32_t interval_us = kModulationDwellUs / kModulationSamples;
+    uint32_t next_us = micros();
+    for (uint16_t i = 0; i < kModulationSamples; ++i) {
+        while (static_cast<int32_t>(micros() - next_us) < 0) {
+        }
+        samples[i] = static_cast<int16_t>(read_rssi_dbm());
+        next_us += interval_us;
+    }
+
+    const ModulationDecision decision = modulation_classify(samples, kModulationSamples, static_cast<int16_t>(floor_dbm));
+    const ModulationFeatures &f = decision.features;
+    Serial.printf("    [Modulation] %s (%u%%) | ecart %d dB | bimodalite %.2f | transitions %u\n",
+                  modulation_class_name(decision.modulation),
+                  static_cast<unsigned>(decision.confidence_pct),
+                  f.max_dbm - f.min_dbm,
+                  f.bimodality,
+                  static_cast<unsigned>(f.transitions));
+    return decision;
 }
 
 }  // namespace
@@ -128,19 +555,35 @@ bool cc1101_manager_init(int rssi_threshold) {
         return false;
     }
 
-    cc1101.setFrequency(433.92);
+    disable_autocal();
+    capture_profiles();
+    // One SCAL per channel now; later hops restore FSCAL instead of recalibrating.
+    calibrate_channels();
+    g_noise_floor.init(g_noise_cells, kSubGHzChannelCount);
+    g_scheduler.init(kSubGHzChannelCount, kScheduleSlotsPerFrame, kScheduleGuaranteedSlots);
+    g_emitters.init(kSubGHzChannelCount);
+    for (uint32_t pinned_hz : kDefaultPinnedHz) {
+        for (size_t i = 0; i < kSubGHzChannelCount; ++i) {
+            if (kSubGHzChannelTable[i].frequency_hz == pinned_hz) {
+                g_scheduler.set_pinned(i, true);
+            }
+        }
+    }
+    Serial.printf("[CC1101] Ordonnanceur: %u creneaux/passe, revisite <= %u passes\n",
+                  kScheduleSlotsPerFrame,
+                  g_scheduler.worst_case_revisit_frames());
     g_need_scan_reinit = false;
 
     Serial.println("[CC1101] ✓ Initialise avec succes");
     Serial.printf("[CONFIG] Seuil RSSI: %d dBm\n", rssi_threshold);
-    Serial.printf("[CONFIG] Nombre de frequences: %d\n",
-                  static_cast<int>(sizeof(kSubGHzFrequencyList) / sizeof(kSubGHzFrequencyList[0])));
+    Serial.printf("[CONFIG] Nombre de frequences: %d\n", static_cast<int>(kSubGHzChannelCount));
     return true;
 }
 
 Cc1101ScanResult cc1101_manager_scan_once(int rssi_threshold) {
     FrequencyRSSI freq_rssi = {
         .frequency_coarse = 0,
+        .channel_coarse = 0,
         .rssi_coarse = -100,
         .frequency_fine = 0,
         .rssi_fine = -100,
@@ -150,7 +593,7 @@ Cc1101ScanResult cc1101_manager_scan_once(int rssi_threshold) {
     g_scan_count++;
 
     if (g_need_scan_reinit) {
-        // First scan after spectrum screen gets a full radio reset path.
+        // First scan after spectrum screen verifies the register file against the shadow.
         if (!reinit_for_scan()) {
             return Cc1101ScanResult{};
         }
@@ -158,64 +601,135 @@ Cc1101ScanResult cc1101_manager_scan_once(int rssi_threshold) {
         apply_scan_profile();
     }
 
-    // Coarse scan over known sub-GHz channels.
-    for (size_t i = 0; i < sizeof(kSubGHzFrequencyList) / sizeof(kSubGHzFrequencyList[0]); i++) {
-        const uint32_t freq = kSubGHzFrequencyList[i];
-        cc1101.setFrequency(freq / 1e6);
-        cc1101.receiveDirect();
-        delay(3);
-        const int rssi = cc1101.getRSSI();
+    if (!ensure_channel_calibration()) {
+        return Cc1101ScanResult{};
+    }
+
+    // Coarse scan in scheduler order: pinned and recently active channels get extra visits.
+    // Relative mode ranks channels by their excess over their own noise floor.
+    int best_rssi = -128;
+    int best_excess = INT16_MIN;
+    const uint16_t slot_count = g_scheduler.plan_frame();
+    const uint8_t *slots = g_scheduler.slots();
+    for (uint16_t s = 0; s < slot_count; s++) {
+        const size_t i = slots[s];
+        const uint32_t freq = kSubGHzChannelTable[i].frequency_hz;
+        fast_retune(kSubGHzChannelTable[i], g_channel_cal[i]);
+        const int rssi = dwell_and_read_rssi(&g_channel_dwell[i]);
+        // Rate-limited per channel inside the tracker: favoured channels are visited many times
+        // per pass and passes run ~100/s, yet the floor still adapts at 4 samples/s.
+        g_noise_floor.update(i, rssi, millis());
+        if (rssi > best_rssi) {
+            best_rssi = rssi;
+        }
 
-        if (rssi > freq_rssi.rssi_coarse) {
+        int score = rssi;
+        if (g_relative_threshold) {
+            if (!g_noise_floor.is_ready(i)) {
+                continue;
+            }
+            score = rssi - g_noise_floor.floor_dbm(i);
+        }
+        if (g_relative_threshold ? (score >= g_noise_margin_db) : (rssi > rssi_threshold)) {
+            g_scheduler.report_activity(i);
+        }
+        if (score > best_excess) {
+            best_excess = score;
             freq_rssi.rssi_coarse = rssi;
             freq_rssi.frequency_coarse = freq;
+            freq_rssi.channel_coarse = i;
         }
     }
 
     Cc1101ScanResult result{};
-    result.best_rssi_dbm = freq_rssi.rssi_coarse;
+    result.best_rssi_dbm = best_rssi;
     result.scan_count = g_scan_count;
 
-    if (freq_rssi.rssi_coarse <= rssi_threshold) {
+    if ((g_scan_count % kDwellReportEveryScans) == 0) {
+        cc1101_manager_print_dwell_stats();
+        cc1101_manager_print_schedule();
+    }
+
+    const bool triggered = g_relative_threshold ? (best_excess >= g_noise_margin_db)
+                                                : (freq_rssi.rssi_coarse > rssi_threshold);
+    if (!triggered) {
         return result;
     }
+    const int coarse_floor = g_noise_floor.floor_dbm(freq_rssi.channel_coarse);
+    Cc1101CalWord coarse_cal = g_channel_cal[freq_rssi.channel_coarse];
+
+    // Tracking: an emitter refined moments ago on this channel is confirmed with one dwell
+    // at its cached frequency, under the same criterion as the coarse hit.
+    const uint32_t now_ms = millis();
+    const EmitterCacheEntry *cached = g_emitters.lookup(freq_rssi.channel_coarse, now_ms);
+    if (cached) {
+        switch_profile(PROFILE_FINE);
+        const int verify_rssi = fine_probe(cached->freq_hz, &coarse_cal);
+        const bool confirmed = g_relative_threshold ? (verify_rssi - coarse_floor >= g_noise_margin_db)
+                                                    : (verify_rssi > rssi_threshold);
+        if (confirmed) {
+            g_emitters.touch(freq_rssi.channel_coarse, verify_rssi, now_ms);
+            // The verify dwell ran in the 2-FSK fine profile; leave an OOK emitter in the OOK
+            // profile, as the full path does, so GDO0 carries its envelope for capture.
+            if (cached->modulation != MODULATION_FSK) {
+                tune_ook(cc1101_make_freq_word(cached->freq_hz), coarse_cal);
+            }
+            Serial.printf("[TRACK] %.3f MHz | RSSI: %d dBm | %s | suivi #%u\n",
+                          cached->freq_hz / 1e6,
+                          verify_rssi,
+                          modulation_class_name(cached->modulation),
+                          static_cast<unsigned>(cached->tracked_hits));
+            result.signal_detected = true;
+            result.tracked = true;
+            result.detected_freq_mhz = cached->freq_hz / 1e6;
+            result.detected_rssi_dbm = verify_rssi;
+            result.is_fsk = (cached->modulation == MODULATION_FSK);
+            result.modulation = cached->modulation;
+            result.modulation_confidence_pct = cached->confidence_pct;
+            result.noise_floor_dbm = coarse_floor;
+            return result;
+        }
+        Serial.printf("[TRACK] %.3f MHz perdu (%d dBm), affinement complet\n", cached->freq_hz / 1e6, verify_rssi);
+        g_emitters.invalidate(freq_rssi.channel_coarse);
+    }
 
     Serial.println("\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
     Serial.printf("🔍 Signal detecte (scan #%d)\n", g_scan_count);
     Serial.println("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
-    Serial.printf("  [Scan grossier] Frequence: %.2f MHz | RSSI: %d dBm\n",
-                  freq_rssi.frequency_coarse / 1e6, freq_rssi.rssi_coarse);
-
-    cc1101.setRxBandwidth(58);
-    Serial.println("  [Scan fin] Affinement en cours...");
-
-    // Fine scan around the best coarse hit.
-    for (uint32_t f = freq_rssi.frequency_coarse - 300000;
-         f <= freq_rssi.frequency_coarse + 300000;
-         f += 20000) {
-        cc1101.setFrequency(f / 1e6);
-        cc1101.receiveDirect();
-        delay(3);
-        const int rssi = cc1101.getRSSI();
-
-        if (rssi > freq_rssi.rssi_fine) {
-            freq_rssi.rssi_fine = rssi;
-            freq_rssi.frequency_fine = f;
-        }
-    }
+    Serial.printf("  [Scan grossier] Frequence: %.2f MHz | RSSI: %d dBm | bruit: %d dBm\n",
+                  freq_rssi.frequency_coarse / 1e6, freq_rssi.rssi_coarse, coarse_floor);
+
+    switch_profile(PROFILE_FINE);
+    Serial.printf("  [Scan fin] Affinement en cours (%s)...\n", freq_refine_strategy_name(g_refine_strategy));
 
-    Serial.printf("  [Scan fin] Frequence affinee: %.2f MHz | RSSI: %d dBm\n",
-                  freq_rssi.frequency_fine / 1e6, freq_rssi.rssi_fine);
+    // Fine search around the best coarse hit, reusing the coarse channel calibration.
+    const FreqRefineWindow window = {freq_rssi.frequency_coarse, kFineHalfSpanHz, kFineResolutionHz};
+    const FreqRefineResult fine = freq_refine(g_refine_strategy, window, fine_probe, &coarse_cal);
+    freq_rssi.frequency_fine = fine.freq_hz;
+    freq_rssi.rssi_fine = fine.rssi_dbm;
+
+    Serial.printf("  [Scan fin] Frequence affinee: %.2f MHz | RSSI: %d dBm | %u reglages\n",
+                  freq_rssi.frequency_fine / 1e6, freq_rssi.rssi_fine, static_cast<unsigned>(fine.probes));
 
     Serial.println("  [Detection] Analyse de la modulation...");
-    freq_rssi.is_fsk = detect_modulation(freq_rssi.frequency_fine / 1e6);
+    // Until the floor is trusted the carrier has to clear the detection threshold instead.
+    const int modulation_floor = g_noise_floor.is_ready(freq_rssi.channel_coarse)
+                                     ? coarse_floor
+                                     : rssi_threshold - MODULATION_MIN_CARRIER_DB;
+    const ModulationDecision modulation =
+        detect_modulation(cc1101_make_freq_word(freq_rssi.frequency_fine), coarse_cal, modulation_floor);
+    freq_rssi.is_fsk = (modulation.modulation == MODULATION_FSK);
+    // A burst that ended before the modulation dwell is left uncached: the next hit refines again.
+    if (modulation.modulation != MODULATION_UNKNOWN) {
+        g_emitters.store(freq_rssi.channel_coarse, freq_rssi.frequency_fine, freq_rssi.rssi_fine, modulation, millis());
+    }
 
     Serial.println("\n  ╔════════════════════════════════════╗");
     Serial.printf("  ║  🎯 SIGNAL DETECTE                 ║\n");
     Serial.println("  ╠════════════════════════════════════╣");
     Serial.printf("  ║  Frequence: %.2f MHz          ║\n", freq_rssi.frequency_fine / 1e6);
     Serial.printf("  ║  RSSI:      %d dBm               ║\n", freq_rssi.rssi_fine);
-    Serial.printf("  ║  Modulation: %-18s ║\n", freq_rssi.is_fsk ? "FSK" : "ASK/OOK");
+    Serial.printf("  ║  Modulation: %-18s ║\n", modulation_class_name(modulation.modulation));
     Serial.println("  ╚════════════════════════════════════╝");
     Serial.println("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n");
 
@@ -223,6 +737,9 @@ Cc1101ScanResult cc1101_manager_scan_once(int rssi_threshold) {
     result.detected_freq_mhz = freq_rssi.frequency_fine / 1e6;
     result.detected_rssi_dbm = freq_rssi.rssi_fine;
     result.is_fsk = freq_rssi.is_fsk;
+    result.modulation = modulation.modulation;
+    result.modulation_confidence_pct = modulation.confidence_pct;
+    result.noise_floor_dbm = coarse_floor;
     return result;
 }
 
@@ -241,7 +758,6 @@ bool cc1101_manager_capture_sweep(float start_freq_mhz,
 
     if (sample_count < 2 || sample_count > CC1101_SWEEP_MAX_SAMPLES) {
         *out_result = result;
-        apply_scan_profile();
         return false;
     }
 
@@ -258,33 +774,163 @@ bool cc1101_manager_capture_sweep(float start_freq_mhz,
     result.end_freq_mhz = end;
     result.sample_count = sample_count;
 
-    // Uniform sweep over the requested band.
-    const float freq_step = (end - start) / static_cast<float>(sample_count - 1);
+    // Uniform sweep over the requested band, on an integer Hz grid so calibrations can be reused.
+    const uint32_t start_hz = static_cast<uint32_t>(lroundf(start * 1e6f));
+    const uint32_t step_hz = static_cast<uint32_t>(lroundf((end - start) * 1e6f)) / (sample_count - 1);
 
     apply_sweep_profile();
+    if (!ensure_sweep_calibration(start_hz, step_hz, sample_count)) {
+        Serial.println("[CC1101] sweep calibration timeout");
+        *out_result = result;
+        return false;
+    }
 
+    int32_t rssi_sum = 0;
     for (uint16_t i = 0; i < sample_count; ++i) {
-        const float freq_mhz = start + freq_step * static_cast<float>(i);
-        cc1101.setFrequency(freq_mhz);
-        cc1101.receiveDirect();
-        delayMicroseconds(2500);
-
-        const int rssi = cc1101.getRSSI();
+        const uint32_t freq_hz = start_hz + step_hz * i;
+        fast_retune(cc1101_make_freq_word(freq_hz), g_sweep_cal.cal[i]);
+        const int rssi = dwell_and_read_rssi(&g_sweep_dwell);
         result.rssi_dbm[i] = static_cast<int16_t>(rssi);
+        rssi_sum += rssi;
 
         if (rssi > result.max_rssi_dbm) {
             result.max_rssi_dbm = rssi;
-            result.max_freq_mhz = freq_mhz;
+            result.max_freq_mhz = freq_hz / 1e6f;
         }
     }
 
-    apply_scan_profile();
+    // Sub-bin peak positions, so a coarse sweep still locates carriers precisely.
+    const int16_t peak_floor = static_cast<int16_t>(rssi_sum / sample_count + kSweepPeakMarginDb);
+    result.peak_count = peak_find_top_k(result.rssi_dbm,
+                                        sample_count,
+                                        start_hz / 1e6f,
+                                        step_hz / 1e6f,
+                                        peak_floor,
+                                        kSweepPeakMinSeparation,
+                                        result.peaks,
+                                        CC1101_SWEEP_MAX_PEAKS);
+    if (result.peak_count > 0) {
+        result.max_freq_mhz = result.peaks[0].freq_mhz;
+    }
+
+    result.timestamp_ms = millis();
+    // Stay in the sweep profile: back-to-back sweeps then cost no register writes,
+    // and scan_once() switches back with a diff when detection resumes.
     result.valid = true;
     *out_result = result;
     return true;
 }
 
+void cc1101_manager_set_refine_strategy(FreqRefineStrategy strategy) {
+    if (strategy >= FREQ_REFINE_STRATEGY_COUNT) {
+        return;
+    }
+    g_refine_strategy = strategy;
+}
+
+FreqRefineStrategy cc1101_manager_get_refine_strategy() {
+    return g_refine_strategy;
+}
+
 void cc1101_manager_restore_scan_mode() {
-    // Defer full reinit to next scan_once call.
+    // Defer shadow verification to next scan_once call.
     g_need_scan_reinit = true;
 }
+
+void cc1101_manager_set_relative_threshold(bool enabled, int margin_db) {
+    g_relative_threshold = enabled;
+    g_noise_margin_db = margin_db;
+}
+
+int cc1101_manager_get_noise_floor_dbm(size_t channel_index) {
+    return g_noise_floor.floor_dbm(static_cast<uint16_t>(channel_index));
+}
+
+bool cc1101_manager_set_channel_pinned(size_t channel_index, bool pinned) {
+    if (channel_index >= kSubGHzChannelCount) {
+        return false;
+    }
+    g_scheduler.set_pinned(channel_index, pinned);
+    return true;
+}
+
+size_t cc1101_manager_get_schedule(uint8_t *out_channels, size_t max_count) {
+    const size_t count = g_scheduler.slot_count();
+    if (!out_channels) {
+        return count;
+    }
+    const size_t copied = (count < max_count) ? count : max_count;
+    memcpy(out_channels, g_scheduler.slots(), copied);
+    return copied;
+}
+
+void cc1101_manager_print_schedule() {
+    Serial.printf("[SCHED] passe #%lu, %u creneaux, revisite <= %u passes\n",
+                  static_cast<unsigned long>(g_scheduler.frame_count()),
+                  g_scheduler.slot_count(),
+                  g_scheduler.worst_case_revisit_frames());
+    for (size_t i = 0; i < kSubGHzChannelCount; ++i) {
+        const uint8_t weight = g_scheduler.weight(i);
+        if (weight == 0) {
+            continue;
+        }
+        uint16_t visits = 0;
+        for (uint16_t s = 0; s < g_scheduler.slot_count(); ++s) {
+            if (g_scheduler.slots()[s] == i) {
+                visits++;
+            }
+        }
+        Serial.printf("[SCHED] %8.3f MHz poids=%u%s visites/passe=%u\n",
+                      kSubGHzChannelTable[i].frequency_hz / 1e6,
+                      weight,
+                      g_scheduler.is_pinned(i) ? " (epingle)" : "",
+                      visits);
+    }
+}
+
+int cc1101_manager_gdo0_gpio() {
+    return CC1101_GDO0;
+}
+
+size_t cc1101_manager_channel_count() {
+    return kSubGHzChannelCount;
+}
+
+bool cc1101_manager_get_dwell_stats(size_t channel_index, Cc1101DwellStats *out_stats) {
+    if (!out_stats || channel_index >= kSubGHzChannelCount) {
+        return false;
+    }
+    *out_stats = g_channel_dwell[channel_index];
+    return true;
+}
+
+void cc1101_manager_print_dwell_stats() {
+    Serial.printf("[DWELL] settle=%lu us\n", static_cast<unsigned long>(g_rssi_settle_us));
+    for (size_t i = 0; i < kSubGHzChannelCount; ++i) {
+        const Cc1101DwellStats &st = g_channel_dwell[i];
+        if (st.samples == 0) {
+            continue;
+        }
+        Serial.printf("[DWELL] %8.3f MHz n=%lu moy=%lu min=%lu max=%lu us\n",
+                      kSubGHzChannelTable[i].frequency_hz / 1e6,
+                      static_cast<unsigned long>(st.samples),
+                      static_cast<unsigned long>(st.total_us / st.samples),
+                      static_cast<unsigned long>(st.min_us),
+                      static_cast<unsigned long>(st.max_us));
+    }
+
+    const Cc1101DwellStats *aggregates[] = {&g_fine_dwell, &g_sweep_dwell};
+    const char *names[] = {"fin", "sweep"};
+    for (size_t i = 0; i < 2; ++i) {
+        const Cc1101DwellStats &st = *aggregates[i];
+        if (st.samples == 0) {
+            continue;
+        }
+        Serial.printf("[DWELL] %-12s n=%lu moy=%lu min=%lu max=%lu us\n",
+                      names[i],
+                      static_cast<unsigned long>(st.samples),
+                      static_cast<unsigned long>(st.total_us / st.samples),
+                      static_cast<unsigned long>(st.min_us),
+                      static_cast<unsigned long>(st.max_us));
+    }
+}
@@ -1,5 +1,9 @@
 #pragma once
 
+#include "freq_refine.h"
+#include "modulation_classifier.h"
+#include "peak_finder.h"
+
 #include <stddef.h>
 #include <stdint.h>
 
@@ -8,11 +12,20 @@ struct Cc1101ScanResult {
     float detected_freq_mhz;
     int detected_rssi_dbm;
     bool is_fsk;
+    // UNKNOWN when the carrier did not clear the floor during the modulation dwell.
+    ModulationClass modulation;
+    // Confidence of the modulation decision, 0..100.
+    uint8_t modulation_confidence_pct;
+    // Noise floor of the coarse channel that triggered.
+    int noise_floor_dbm;
+    // Confirmed from the emitter cache with one dwell; frequency and modulation are the cached ones.
+    bool tracked;
     int best_rssi_dbm;
     int scan_count;
 };
 
 constexpr size_t CC1101_SWEEP_MAX_SAMPLES = 128;
+constexpr uint8_t CC1101_SWEEP_MAX_PEAKS = 4;
 
 struct Cc1101SweepResult {
     bool valid;
@@ -20,8 +33,22 @@ struct Cc1101SweepResult {
     float end_freq_mhz;
     uint16_t sample_count;
     int16_t rssi_dbm[CC1101_SWEEP_MAX_SAMPLES];
+    // Strongest peak: frequency interpolated between bins, RSSI as measured.
     float max_freq_mhz;
     int max_rssi_dbm;
+    // Strongest emitters first, interpolated frequency and RSSI.
+    uint8_t peak_count;
+    SpectrumPeak peaks[CC1101_SWEEP_MAX_PEAKS];
+    uint32_t timestamp_ms;
+};
+
+// Time spent between the RX strobe and a valid RSSI reading.
+struct Cc1101DwellStats {
+    uint32_t samples;
+    uint32_t last_us;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t total_us;
 };
 
 bool cc1101_manager_init(int rssi_threshold);
@@ -31,3 +58,26 @@ bool cc1101_manager_capture_sweep(float start_freq_mhz,
                                   uint16_t sample_count,
                                   Cc1101SweepResult *out_result);
 void cc1101_manager_restore_scan_mode();
+
+// Fine search used after a coarse hit (golden-section by default).
+void cc1101_manager_set_refine_strategy(FreqRefineStrategy strategy);
+FreqRefineStrategy cc1101_manager_get_refine_strategy();
+
+// Relative mode: a channel triggers margin_db above its own noise floor (running median)
+// instead of above the absolute threshold passed to scan_once().
+void cc1101_manager_set_relative_threshold(bool enabled, int margin_db);
+int cc1101_manager_get_noise_floor_dbm(size_t channel_index);
+
+// Coarse-scan scheduler: pinned channels (433.92 and 868.35 MHz at boot) and recently active
+// ones are revisited several times per pass; every channel still comes back within a bounded
+// number of passes. get_schedule copies the current pass's visit order (channel indices).
+bool cc1101_manager_set_channel_pinned(size_t channel_index, bool pinned);
+size_t cc1101_manager_get_schedule(uint8_t *out_channels, size_t max_count);
+void cc1101_manager_print_schedule();
+
+// GDO0 carries the demodulated data stream in direct (asynchronous) RX mode.
+int cc1101_manager_gdo0_gpio();
+
+size_t cc1101_manager_channel_count();
+bool cc1101_manager_get_dwell_stats(size_t channel_index, Cc1101DwellStats *out_stats);
+void cc1101_manager_print_dwell_stats();
@@ -0,0 +1,115 @@
+#include "channel_scheduler.h"
+
+bool ChannelScheduler::init(uint16_t channel_count, uint16_t slots_per_frame, uint16_t guaranteed_slots) {
+    if (channel_count == 0 || channel_count > CHANNEL_SCHEDULER_MAX_CHANNELS || slots_per_frame == 0 ||
+        slots_per_frame > CHANNEL_SCHEDULER_MAX_SLOTS || guaranteed_slots == 0 ||
+        guaranteed_slots > slots_per_frame) {
+        return false;
+    }
+    channel_count_ = channel_count;
+    slots_per_frame_ = slots_per_frame;
+    guaranteed_slots_ = guaranteed_slots;
+    for (uint16_t i = 0; i < CHANNEL_SCHEDULER_MAX_CHANNELS; ++i) {
+        pinned_[i] = false;
+    }
+    reset();
+    return true;
+}
+
+void ChannelScheduler::reset() {
+    for (uint16_t i = 0; i < CHANNEL_SCHEDULER_MAX_CHANNELS; ++i) {
+        activity_[i] = 0;
+        credit_[i] = 0;
+    }
+    rr_cursor_ = 0;
+    frame_count_ = 0;
+    slot_count_ = 0;
+}
+
+void ChannelScheduler::set_pinned(uint16_t channel, bool pinned) {
+    if (channel < channel_count_) {
+        pinned_[channel] = pinned;
+    }
+}
+
+bool ChannelScheduler::is_pinned(uint16_t channel) const {
+    return channel < channel_count_ && pinned_[channel];
+}
+
+void ChannelScheduler::report_activity(uint16_t channel) {
+    if (channel < channel_count_) {
+        activity_[channel] = kActivityWeight;
+    }
+}
+
+uint8_t ChannelScheduler::weight(uint16_t channel) const {
+    if (channel >= channel_count_) {
+        return 0;
+    }
+    return static_cast<uint8_t>((pinned_[channel] ? kPinnedWeight : 0) + activity_[channel]);
+}
+
+uint16_t ChannelScheduler::worst_case_revisit_frames() const {
+    if (guaranteed_slots_ == 0) {
+        return 0;
+    }
+    return static_cast<uint16_t>((channel_count_ + guaranteed_slots_ - 1) / guaranteed_slots_);
+}
+
+// Smooth weighted round-robin: every weighted channel earns its weight, the richest is
+// picked and pays the total. Visits come out interleaved rather than in bursts.
+uint16_t ChannelScheduler::pick_weighted() {
+    int16_t total = 0;
+    int16_t best_credit = INT16_MIN;
+    uint16_t best = 0;
+    for (uint16_t i = 0; i < channel_count_; ++i) {
+        const uint8_t w = weight(i);
+        if (w == 0) {
+            continue;
+        }
+        total = static_cast<int16_t>(total + w);
+        credit_[i] = static_cast<int16_t>(credit_[i] + w);
+        if (credit_[i] > best_credit) {
+            best_credit = credit_[i];
+            best = i;
+        }
+    }
+    credit_[best] = static_cast<int16_t>(credit_[best] - total);
+    return best;
+}
+
+uint16_t ChannelScheduler::plan_frame() {
+    if (channel_count_ == 0) {
+        slot_count_ = 0;
+        return 0;
+    }
+
+    uint32_t total_weight = 0;
+    for (uint16_t i = 0; i < channel_count_; ++i) {
+        if (activity_[i] > 0) {
+            activity_[i]--;
+        }
+        const uint8_t w = weight(i);
+        if (w == 0) {
+            credit_[i] = 0;
+        }
+        total_weight += w;
+    }
+
+    // Nothing to favour: the whole frame is round-robin.
+    const uint16_t rr_slots = (total_weight == 0) ? slots_per_frame_ : guaranteed_slots_;
+    for (uint16_t s = 0; s < slots_per_frame_; ++s) {
+        // Bresenham spread: rr_slots round-robin visits evenly placed among the frame's slots.
+        const bool rr = ((static_cast<uint32_t>(s) + 1) * rr_slots) / slots_per_frame_ !=
+                        (static_cast<uint32_t>(s) * rr_slots) / slots_per_frame_;
+        if (rr) {
+            slots_[s] = static_cast<uint8_t>(rr_cursor_);
+            rr_cursor_ = static_cast<uint16_t>((rr_cursor_ + 1) % channel_count_);
+        } else {
+            slots_[s] = static_cast<uint8_t>(pick_weighted());
+        }
+    }
+    slot_count_ = slots_per_frame_;
+    frame_count_++;
+    return slot_count_;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdint.h>
+
+constexpr uint16_t CHANNEL_SCHEDULER_MAX_CHANNELS = 64;
+constexpr uint16_t CHANNEL_SCHEDULER_MAX_SLOTS = 128;
+
+// Builds the coarse-scan visit order, one frame (scan pass) at a time.
+// A fixed share of each frame walks every channel round-robin, which bounds the worst-case
+// revisit time; the remaining slots go to pinned and recently active channels in proportion
+// to their weight (smooth weighted round-robin, so repeated visits are spread over the frame).
+// With nothing pinned or active, every slot is round-robin: a plain uniform scan.
+class ChannelScheduler {
+public:
+    // Weight of a user-pinned channel.
+    static constexpr uint8_t kPinnedWeight = 8;
+    // Weight given by one activity report; decays by one per frame.
+    static constexpr uint8_t kActivityWeight = 8;
+
+    // guaranteed_slots of every slots_per_frame are reserved for the round-robin walk.
+    bool init(uint16_t channel_count, uint16_t slots_per_frame, uint16_t guaranteed_slots);
+    void reset();
+
+    void set_pinned(uint16_t channel, bool pinned);
+    bool is_pinned(uint16_t channel) const;
+    // The channel crossed the detection criterion during the last frame.
+    void report_activity(uint16_t channel);
+    uint8_t weight(uint16_t channel) const;
+
+    // Plans the next frame and returns its slot count; slots() lists channel indices in visit order.
+    uint16_t plan_frame();
+    const uint8_t *slots() const {
+        return slots_;
+    }
+    uint16_t slot_count() const {
+        return slot_count_;
+    }
+    uint16_t channel_count() const {
+        return channel_count_;
+    }
+    uint32_t frame_count() const {
+        return frame_count_;
+    }
+    // Every channel is visited at least once within this many consecutive frames.
+    uint16_t worst_case_revisit_frames() const;
+
+private:
+    uint16_t pick_weighted();
+
+    uint16_t channel_count_ = 0;
+    uint16_t slots_per_frame_ = 0;
+    uint16_t guaranteed_slots_ = 0;
+    uint16_t rr_cursor_ = 0;
+    uint32_t frame_count_ = 0;
+    bool pinned_[CHANNEL_SCHEDULER_MAX_CHANNELS] = {};
+    uint8_t activity_[CHANNEL_SCHEDULER_MAX_CHANNELS] = {};
+    // Smooth weighted round-robin credit, carried across frames.
+    int16_t credit_[CHANNEL_SCHEDULER_MAX_CHANNELS] = {};
+    uint8_t slots_[CHANNEL_SCHEDULER_MAX_SLOTS] = {};
+    uint16_t slot_count_ = 0;
+};
@@ -0,0 +1,65 @@
+#include "emitter_cache.h"
+
+bool EmitterCache::init(uint16_t channel_count, uint32_t validity_ms) {
+    if (channel_count == 0 || channel_count > EMITTER_CACHE_MAX_CHANNELS || validity_ms == 0) {
+        return false;
+    }
+    channel_count_ = channel_count;
+    validity_ms_ = validity_ms;
+    clear();
+    return true;
+}
+
+void EmitterCache::clear() {
+    for (uint16_t i = 0; i < EMITTER_CACHE_MAX_CHANNELS; ++i) {
+        entries_[i] = EmitterCacheEntry{};
+    }
+}
+
+const EmitterCacheEntry *EmitterCache::lookup(uint16_t channel, uint32_t now_ms) const {
+    if (channel >= channel_count_) {
+        return nullptr;
+    }
+    const EmitterCacheEntry &entry = entries_[channel];
+    if (!entry.valid || (now_ms - entry.last_seen_ms) > validity_ms_) {
+        return nullptr;
+    }
+    return &entry;
+}
+
+void EmitterCache::store(uint16_t channel,
+                         uint32_t freq_hz,
+                         int rssi_dbm,
+                         const ModulationDecision &modulation,
+                         uint32_t now_ms) {
+    if (channel >= channel_count_) {
+        return;
+    }
+    EmitterCacheEntry &entry = entries_[channel];
+    entry.valid = true;
+    entry.freq_hz = freq_hz;
+    entry.rssi_dbm = static_cast<int16_t>(rssi_dbm);
+    entry.modulation = modulation.modulation;
+    entry.confidence_pct = modulation.confidence_pct;
+    entry.first_seen_ms = now_ms;
+    entry.last_seen_ms = now_ms;
+    entry.tracked_hits = 0;
+}
+
+void EmitterCache::touch(uint16_t channel, int rssi_dbm, uint32_t now_ms) {
+    if (channel >= channel_count_ || !entries_[channel].valid) {
+        return;
+    }
+    EmitterCacheEntry &entry = entries_[channel];
+    entry.rssi_dbm = static_cast<int16_t>(rssi_dbm);
+    entry.last_seen_ms = now_ms;
+    if (entry.tracked_hits < UINT16_MAX) {
+        entry.tracked_hits++;
+    }
+}
+
+void EmitterCache::invalidate(uint16_t channel) {
+    if (channel < channel_count_) {
+        entries_[channel].valid = false;
+    }
+}
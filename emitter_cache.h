@@ -0,0 +1,47 @@
+#pragma once
+
+#include "modulation_classifier.h"
+
+#include <stdint.h>
+
+constexpr uint16_t EMITTER_CACHE_MAX_CHANNELS = 64;
+
+// Last refined emitter seen on one coarse channel.
+struct EmitterCacheEntry {
+    bool valid;
+    uint32_t freq_hz;
+    int16_t rssi_dbm;
+    ModulationClass modulation;
+    uint8_t confidence_pct;
+    uint32_t first_seen_ms;
+    uint32_t last_seen_ms;
+    // Detections served from this entry without a new refine.
+    uint16_t tracked_hits;
+};
+
+// Refined emitters keyed by coarse channel. A repeat hit on the channel within the
+// validity window can be confirmed with one dwell at the cached frequency.
+class EmitterCache {
+public:
+    // A held remote repeats its frame every few tens of ms; 2 s covers pauses between presses.
+    static constexpr uint32_t kDefaultValidityMs = 2000;
+
+    bool init(uint16_t channel_count, uint32_t validity_ms = kDefaultValidityMs);
+    void clear();
+
+    // Entry still inside the validity window, or null.
+    const EmitterCacheEntry *lookup(uint16_t channel, uint32_t now_ms) const;
+    void store(uint16_t channel, uint32_t freq_hz, int rssi_dbm, const ModulationDecision &modulation, uint32_t now_ms);
+    // The emitter was confirmed again: refresh its level and age, count the skipped refine.
+    void touch(uint16_t channel, int rssi_dbm, uint32_t now_ms);
+    void invalidate(uint16_t channel);
+
+    uint32_t validity_ms() const {
+        return validity_ms_;
+    }
+
+private:
+    EmitterCacheEntry entries_[EMITTER_CACHE_MAX_CHANNELS] = {};
+    uint16_t channel_count_ = 0;
+    uint32_t validity_ms_ = kDefaultValidityMs;
+};
@@ -0,0 +1,318 @@
+#include "energy_accounting.h"
+
+#include <Arduino.h>
+#include <atomic>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace {
+
+// Current at level 0 and at full level, in 0.1 mA. Datasheet typicals and rough board figures:
+// calibrate against a meter before trusting absolute mAh, relative shares are what matter.
+struct RailModel {
+    uint16_t off_ma_x10;
+    uint16_t full_ma_x10;
+};
+
+constexpr RailModel kRailModel[ENERGY_RAIL_COUNT] = {
+    {17, 165},   // CC1101 IDLE 1.7 mA, RX 16.5 mA at 433 MHz
+    {0, 60},     // amplifier quiescent
+    {0, 600},    // backlight at full duty
+    {300, 700},  // ESP32-S3 both cores idle / both busy at 240 MHz
+};
+
+const char *const kRailNames[ENERGY_RAIL_COUNT] = {
+    "Radio",
+    "Ampli",
+    "Ecran",
+    "CPU",
+};
+
+constexpr uint64_t kCpuSampleMinUs = 1000000;
+constexpr uint32_t kCpuReferenceMhz = 240;
+constexpr uint8_t kMaxTrackedTasks = 24;
+// 0.1 mA * us per mAh.
+constexpr float kMaX10UsPerMah = 10.0f * 3600.0f * 1000000.0f;
+
+struct RailState {
+    std::atomic<uint8_t> level{0};
+    uint64_t since_us = 0;
+    uint64_t active_us = 0;
+    uint64_t duty_us = 0;
+    uint64_t charge_ma_x10_us = 0;
+};
+
+portMUX_TYPE g_energy_mux = portMUX_INITIALIZER_UNLOCKED;
+RailState g_rails[ENERGY_RAIL_COUNT];
+uint64_t g_start_us = 0;
+// Active CPU current scales with clock; 1000 = reference clock.
+uint32_t g_cpu_scale_permille = 1000;
+EnergyTaskLoad g_tasks[ENERGY_MAX_TASKS] = {};
+uint8_t g_task_count = 0;
+uint64_t g_last_cpu_sample_us = 0;
+
+uint64_t now_us() {
+    return static_cast<uint64_t>(esp_timer_get_time());
+}
+
+uint32_t current_ma_x10(EnergyRail rail, uint8_t level) {
+    const RailModel &model = kRailModel[rail];
+    uint32_t dynamic = (static_cast<uint32_t>(model.full_ma_x10 - model.off_ma_x10) * level) / ENERGY_LEVEL_FULL;
+    if (rail == ENERGY_RAIL_CPU) {
+        dynamic = (dynamic * g_cpu_scale_permille) / 1000;
+    }
+    return model.off_ma_x10 + dynamic;
+}
+
+// Books [since, now) at level. Caller holds g_energy_mux.
+void integrate(EnergyRail rail, uint64_t now, uint8_t level) {
+    RailState &state = g_rails[rail];
+    if (now <= state.since_us) {
+        return;
+    }
+    const uint64_t dt = now - state.since_us;
+    if (level > 0) {
+        state.active_us += dt;
+    }
+    state.duty_us += (dt * level) / ENERGY_LEVEL_FULL;
+    state.charge_ma_x10_us += dt * current_ma_x10(rail, level);
+    state.since_us = now;
+}
+
+#if (configGENERATE_RUN_TIME_STATS == 1) && (configUSE_TRACE_FACILITY == 1)
+struct TaskRuntime {
+    TaskHandle_t handle;
+    uint32_t runtime;
+};
+
+TaskStatus_t g_status[kMaxTrackedTasks];
+TaskRuntime g_prev[kMaxTrackedTasks] = {};
+uint8_t g_prev_count = 0;
+uint32_t g_prev_total = 0;
+
+uint32_t previous_runtime(TaskHandle_t handle, uint32_t fallback) {
+    for (uint8_t i = 0; i < g_prev_count; ++i) {
+        if (g_prev[i].handle == handle) {
+            return g_prev[i].runtime;
+        }
+    }
+    return fallback;
+}
+
+// Busy share of both cores since the last call, 0..255; -1 on the first call or an overflow.
+int measure_cpu(EnergyTaskLoad *tasks, uint8_t *task_count) {
+    uint32_t total = 0;
+    const UBaseType_t count = uxTaskGetSystemState(g_status, kMaxTrackedTasks, &total);
+    if (count == 0) {
+        return -1;
+    }
+    const uint32_t total_delta = total - g_prev_total;
+    const bool have_prev = g_prev_count > 0 && total_delta > 0;
+
+    uint64_t idle_delta = 0;
+    *task_count = 0;
+    for (UBaseType_t i = 0; i < count && have_prev; ++i) {
+        const TaskStatus_t &task = g_status[i];
+        const uint32_t runtime = static_cast<uint32_t>(task.ulRunTimeCounter);
+        // New task: counted from its creation, which is within this interval anyway.
+        const uint32_t delta = runtime - previous_runtime(task.xHandle, 0);
+        if (strncmp(task.pcTaskName, "IDLE", 4) == 0) {
+            idle_delta += delta;
+            continue;
+        }
+
+        // Insertion into the top list, highest load first.
+        const uint16_t load = static_cast<uint16_t>((static_cast<uint64_t>(delta) * 1000) / total_delta);
+        uint8_t pos = *task_count;
+        while (pos > 0 && tasks[pos - 1].load_permille < load) {
+            if (pos < ENERGY_MAX_TASKS) {
+                tasks[pos] = tasks[pos - 1];
+            }
+            --pos;
+        }
+        if (pos < ENERGY_MAX_TASKS) {
+            strncpy(tasks[pos].name, task.pcTaskName, sizeof(tasks[pos].name) - 1);
+            tasks[pos].name[sizeof(tasks[pos].name) - 1] = '\0';
+            tasks[pos].load_permille = load;
+            if (*task_count < ENERGY_MAX_TASKS) {
+                ++*task_count;
+            }
+        }
+    }
+
+    g_prev_count = static_cast<uint8_t>(count);
+    for (UBaseType_t i = 0; i < count; ++i) {
+        g_prev[i] = {g_status[i].xHandle, static_cast<uint32_t>(g_status[i].ulRunTimeCounter)};
+    }
+    g_prev_total = total;
+    if (!have_prev) {
+        return -1;
+    }
+
+    // Run-time stats count wall time per core; two cores give twice the total.
+    const uint64_t capacity = static_cast<uint64_t>(total_delta) * portNUM_PROCESSORS;
+    const uint64_t busy = (idle_delta < capacity) ? capacity - idle_delta : 0;
+    return static_cast<int>((busy * ENERGY_LEVEL_FULL) / capacity);
+}
+#else
+int measure_cpu(EnergyTaskLoad *tasks, uint8_t *task_count) {
+    (void)tasks;
+    *task_count = 0;
+    return -1;
+}
+#endif
+
+void format_duration(char *buf, size_t len, uint64_t us) {
+    const uint32_t total_s = static_cast<uint32_t>(us / 1000000ULL);
+    snprintf(buf,
+             len,
+             "%luh%02lu",
+             static_cast<unsigned long>(total_s / 3600),
+             static_cast<unsigned long>((total_s / 60) % 60));
+}
+
+uint32_t share_permille(uint64_t part, uint64_t whole) {
+    return (whole > 0) ? static_cast<uint32_t>((part * 1000) / whole) : 0;
+}
+
+}  // namespace
+
+void energy_accounting_init() {
+    const uint64_t now = now_us();
+    portENTER_CRITICAL(&g_energy_mux);
+    g_start_us = now;
+    g_last_cpu_sample_us = now;
+    for (RailState &state : g_rails) {
+        state.since_us = now;
+    }
+    portEXIT_CRITICAL(&g_energy_mux);
+}
+
+void energy_accounting_set_level(EnergyRail rail, uint8_t level) {
+    if (rail >= ENERGY_RAIL_COUNT || g_rails[rail].level.load(std::memory_order_relaxed) == level) {
+        return;
+    }
+    const uint64_t now = now_us();
+    portENTER_CRITICAL(&g_energy_mux);
+    integrate(rail, now, g_rails[rail].level.load(std::memory_order_relaxed));
+    g_rails[rail].level.store(level, std::memory_order_relaxed);
+    portEXIT_CRITICAL(&g_energy_mux);
+}
+
+void energy_accounting_sample_cpu() {
+    const uint64_t now = now_us();
+    if (now - g_last_cpu_sample_us < kCpuSampleMinUs) {
+        return;
+    }
+    g_last_cpu_sample_us = now;
+
+    // Task list walk runs outside the spinlock; only the booking is short.
+    EnergyTaskLoad tasks[ENERGY_MAX_TASKS] = {};
+    uint8_t task_count = 0;
+    const int busy_level = measure_cpu(tasks, &task_count);
+    const uint32_t scale = (getCpuFrequencyMhz() * 1000) / kCpuReferenceMhz;
+
+    portENTER_CRITICAL(&g_energy_mux);
+    if (busy_level >= 0) {
+        // The measured share applies to the interval that just ended.
+        integrate(ENERGY_RAIL_CPU, now, static_cast<uint8_t>(busy_level));
+        g_rails[ENERGY_RAIL_CPU].level.store(static_cast<uint8_t>(busy_level), std::memory_order_relaxed);
+        memcpy(g_tasks, tasks, sizeof(g_tasks));
+        g_task_count = task_count;
+    } else {
+        integrate(ENERGY_RAIL_CPU, now, g_rails[ENERGY_RAIL_CPU].level.load(std::memory_order_relaxed));
+    }
+    g_cpu_scale_permille = scale;
+    portEXIT_CRITICAL(&g_energy_mux);
+}
+
+void energy_accounting_snapshot(EnergySnapshot *out) {
+    if (!out) {
+        return;
+    }
+    const uint64_t now = now_us();
+    uint64_t charge[ENERGY_RAIL_COUNT];
+
+    portENTER_CRITICAL(&g_energy_mux);
+    out->uptime_us = now - g_start_us;
+    for (uint8_t i = 0; i < ENERGY_RAIL_COUNT; ++i) {
+        const EnergyRail rail = static_cast<EnergyRail>(i);
+        RailState &state = g_rails[i];
+        integrate(rail, now, state.level.load(std::memory_order_relaxed));
+        out->rails[i].active_us = state.active_us;
+        out->rails[i].duty_us = state.duty_us;
+        out->rails[i].level = state.level.load(std::memory_order_relaxed);
+        charge[i] = state.charge_ma_x10_us;
+    }
+    memcpy(out->tasks, g_tasks, sizeof(out->tasks));
+    out->task_count = g_task_count;
+    portEXIT_CRITICAL(&g_energy_mux);
+
+    // Float math outside the spinlock.
+    out->total_mah = 0.0f;
+    for (uint8_t i = 0; i < ENERGY_RAIL_COUNT; ++i) {
+        out->rails[i].mah = static_cast<float>(charge[i]) / kMaX10UsPerMah;
+        out->total_mah += out->rails[i].mah;
+    }
+    const float hours = static_cast<float>(out->uptime_us) / 3600e6f;
+    out->avg_ma = (hours > 0.0f) ? out->total_mah / hours : 0.0f;
+}
+
+size_t energy_accounting_format(char *buf, size_t len) {
+    if (!buf || len == 0) {
+        return 0;
+    }
+    EnergySnapshot snap;
+    energy_accounting_snapshot(&snap);
+
+    char uptime[16];
+    format_duration(uptime, sizeof(uptime), snap.uptime_us);
+    size_t used = snprintf(buf, len, "%s | moy %.1f mA | %.1f mAh\n", uptime, snap.avg_ma, snap.total_mah);
+    for (uint8_t i = 0; i < ENERGY_RAIL_COUNT && used < len; ++i) {
+        const EnergyRailStats &rail = snap.rails[i];
+        const uint32_t active = share_permille(rail.active_us, snap.uptime_us);
+        const uint32_t duty = share_permille(rail.duty_us, snap.uptime_us);
+        used += snprintf(buf + used,
+                         len - used,
+                         "%-6s actif %3lu%% charge %3lu%% %6.1f mAh (%.0f%%)\n",
+                         kRailNames[i],
+                         static_cast<unsigned long>(active / 10),
+                         static_cast<unsigned long>(duty / 10),
+                         rail.mah,
+                         (snap.total_mah > 0.0f) ? 100.0f * rail.mah / snap.total_mah : 0.0f);
+    }
+    if (used < len && snap.task_count > 0) {
+        used += snprintf(buf + used, len - used, "Taches:");
+        for (uint8_t i = 0; i < snap.task_count && used < len; ++i) {
+            used += snprintf(buf + used,
+                             len - used,
+                             " %s %u.%u%%",
+                             snap.tasks[i].name,
+                             snap.tasks[i].load_permille / 10,
+                             snap.tasks[i].load_permille % 10);
+        }
+    }
+    return (used < len) ? used : len - 1;
+}
+
+void energy_accounting_print() {
+    char buf[512];
+    energy_accounting_format(buf, sizeof(buf));
+    // One prefixed serial line per text line.
+    char *line = buf;
+    while (line && *line) {
+        char *next = strchr(line, '\n');
+        if (next) {
+            *next++ = '\0';
+        }
+        Serial.printf("[ENERGY] %s\n", line);
+        line = next;
+    }
+}
+
+const char *energy_rail_name(EnergyRail rail) {
+    return (rail < ENERGY_RAIL_COUNT) ? kRailNames[rail] : "?";
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Power consumers tracked separately.
+enum EnergyRail : uint8_t {
+    // CC1101: level 0 = IDLE, full = RX.
+    ENERGY_RAIL_RADIO = 0,
+    // Speaker amplifier enable on the IO expander.
+    ENERGY_RAIL_AMP,
+    // LCD backlight, level = PWM duty.
+    ENERGY_RAIL_BACKLIGHT,
+    // Both cores, level = busy share from FreeRTOS run-time stats.
+    ENERGY_RAIL_CPU,
+    ENERGY_RAIL_COUNT,
+};
+
+constexpr uint8_t ENERGY_LEVEL_OFF = 0;
+constexpr uint8_t ENERGY_LEVEL_FULL = 255;
+constexpr uint8_t ENERGY_MAX_TASKS = 6;
+
+struct EnergyRailStats {
+    // Time spent at a non-zero level.
+    uint64_t active_us;
+    // Time weighted by level: full-power equivalent.
+    uint64_t duty_us;
+    float mah;
+    uint8_t level;
+};
+
+struct EnergyTaskLoad {
+    char name[16];
+    // Share of one core over the last CPU sample.
+    uint16_t load_permille;
+};
+
+struct EnergySnapshot {
+    uint64_t uptime_us;
+    EnergyRailStats rails[ENERGY_RAIL_COUNT];
+    float total_mah;
+    float avg_ma;
+    EnergyTaskLoad tasks[ENERGY_MAX_TASKS];
+    uint8_t task_count;
+};
+
+// Starts every rail at level 0 from now.
+void energy_accounting_init();
+// Timestamps a transition and integrates the time spent at the previous level. Any task; an
+// unchanged level returns before taking the lock, so hot paths can call it freely.
+void energy_accounting_set_level(EnergyRail rail, uint8_t level);
+// Reads FreeRTOS run-time stats and books the CPU rail; at most once per second, extra calls are
+// ignored. Without run-time stats in the build the CPU rail stays at its idle current.
+void energy_accounting_sample_cpu();
+
+void energy_accounting_snapshot(EnergySnapshot *out);
+// Multi-line summary for the diagnostics screen; returns the length written.
+size_t energy_accounting_format(char *buf, size_t len);
+void energy_accounting_print();
+
+const char *energy_rail_name(EnergyRail rail);
@@ -0,0 +1,181 @@
+#include "freq_refine.h"
+
+namespace {
+
+constexpr uint8_t kProbeCacheSize = 16;
+// 1 / golden ratio, in 1/65536 units.
+constexpr uint32_t kInvPhiQ16 = 40503;
+
+// Wraps the probe callback: caches measurements and tracks the best one.
+class ProbeSession {
+public:
+    ProbeSession(FreqRefineProbe probe, void *ctx) : probe_(probe), ctx_(ctx) {
+        result_.freq_hz = 0;
+        result_.rssi_dbm = -128;
+        result_.probes = 0;
+    }
+
+    int measure(uint32_t freq_hz) {
+        for (uint8_t i = 0; i < cache_size_; ++i) {
+            if (cache_freq_[i] == freq_hz) {
+                return cache_rssi_[i];
+            }
+        }
+
+        const int rssi = probe_(freq_hz, ctx_);
+        result_.probes++;
+        const uint8_t slot = cache_next_;
+        cache_freq_[slot] = freq_hz;
+        cache_rssi_[slot] = rssi;
+        cache_next_ = (cache_next_ + 1) % kProbeCacheSize;
+        if (cache_size_ < kProbeCacheSize) {
+            cache_size_++;
+        }
+
+        if (result_.probes == 1 || rssi > result_.rssi_dbm) {
+            result_.rssi_dbm = rssi;
+            result_.freq_hz = freq_hz;
+        }
+        return rssi;
+    }
+
+    const FreqRefineResult &result() const {
+        return result_;
+    }
+
+private:
+    FreqRefineProbe probe_;
+    void *ctx_;
+    FreqRefineResult result_;
+    uint32_t cache_freq_[kProbeCacheSize] = {0};
+    int cache_rssi_[kProbeCacheSize] = {0};
+    uint8_t cache_size_ = 0;
+    uint8_t cache_next_ = 0;
+};
+
+uint32_t window_low(const FreqRefineWindow &window) {
+    return (window.center_hz > window.half_span_hz) ? window.center_hz - window.half_span_hz : 0;
+}
+
+uint32_t window_high(const FreqRefineWindow &window) {
+    return window.center_hz + window.half_span_hz;
+}
+
+void refine_linear(const FreqRefineWindow &window, ProbeSession *session) {
+    const uint32_t high = window_high(window);
+    for (uint32_t f = window_low(window); f <= high; f += window.resolution_hz) {
+        session->measure(f);
+    }
+}
+
+void refine_hill_climb(const FreqRefineWindow &window, ProbeSession *session) {
+    const uint32_t low = window_low(window);
+    const uint32_t high = window_high(window);
+    uint32_t center = window.center_hz;
+    int center_rssi = session->measure(center);
+    uint32_t step = window.half_span_hz / 2;
+
+    while (step >= window.resolution_hz) {
+        const uint32_t left = (center - low >= step) ? center - step : low;
+        const uint32_t right = (high - center >= step) ? center + step : high;
+        const int left_rssi = session->measure(left);
+        const int right_rssi = session->measure(right);
+
+        // Move towards the stronger side at the same step, otherwise narrow down.
+        if (left_rssi > center_rssi && left_rssi >= right_rssi) {
+            center = left;
+            center_rssi = left_rssi;
+        } else if (right_rssi > center_rssi) {
+            center = right;
+            center_rssi = right_rssi;
+        } else {
+            step /= 2;
+        }
+    }
+}
+
+void refine_golden_section(const FreqRefineWindow &window, ProbeSession *session) {
+    const uint32_t low = window_low(window);
+    const uint32_t high = window_high(window);
+    const uint32_t quarter = window.half_span_hz / 2;
+
+    // Outside the main lobe RSSI sits on the noise floor and the section test cannot tell
+    // the sides apart: bracket the lobe from three spread probes first.
+    // Seeds stay inside the window, as every later probe does.
+    const uint32_t seeds[3] = {(window.center_hz - low > quarter) ? window.center_hz - quarter : low,
+                               window.center_hz,
+                               (high - window.center_hz > quarter) ? window.center_hz + quarter : high};
+    uint32_t best = window.center_hz;
+    int best_rssi = -128;
+    for (uint32_t seed : seeds) {
+        const int rssi = session->measure(seed);
+        if (rssi > best_rssi) {
+            best_rssi = rssi;
+            best = seed;
+        }
+    }
+
+    uint32_t a = (best - low > quarter) ? best - quarter : low;
+    uint32_t b = (high - best > quarter) ? best + quarter : high;
+    uint32_t c = b - static_cast<uint32_t>((static_cast<uint64_t>(b - a) * kInvPhiQ16) >> 16);
+    uint32_t d = a + static_cast<uint32_t>((static_cast<uint64_t>(b - a) * kInvPhiQ16) >> 16);
+    int rssi_c = session->measure(c);
+    int rssi_d = session->measure(d);
+
+    // The bracket shrinks by 1/phi per probe; at two resolution steps wide, the best
+    // measured point is within one step of the maximum.
+    while (b - a > 2 * window.resolution_hz && c < d) {
+        if (rssi_c >= rssi_d) {
+            b = d;
+            d = c;
+            rssi_d = rssi_c;
+            c = b - static_cast<uint32_t>((static_cast<uint64_t>(b - a) * kInvPhiQ16) >> 16);
+            rssi_c = session->measure(c);
+        } else {
+            a = c;
+            c = d;
+            rssi_c = rssi_d;
+            d = a + static_cast<uint32_t>((static_cast<uint64_t>(b - a) * kInvPhiQ16) >> 16);
+            rssi_d = session->measure(d);
+        }
+    }
+}
+
+}  // namespace
+
+FreqRefineResult freq_refine(FreqRefineStrategy strategy,
+                             const FreqRefineWindow &window,
+                             FreqRefineProbe probe,
+                             void *ctx) {
+    ProbeSession session(probe, ctx);
+    if (!probe || window.resolution_hz == 0) {
+        return session.result();
+    }
+
+    switch (strategy) {
+        case FREQ_REFINE_HILL_CLIMB:
+            refine_hill_climb(window, &session);
+            break;
+        case FREQ_REFINE_GOLDEN_SECTION:
+            refine_golden_section(window, &session);
+            break;
+        case FREQ_REFINE_LINEAR:
+        default:
+            refine_linear(window, &session);
+            break;
+    }
+    return session.result();
+}
+
+const char *freq_refine_strategy_name(FreqRefineStrategy strategy) {
+    switch (strategy) {
+        case FREQ_REFINE_LINEAR:
+            return "linear";
+        case FREQ_REFINE_HILL_CLIMB:
+            return "hill-climb";
+        case FREQ_REFINE_GOLDEN_SECTION:
+            return "golden-section";
+        default:
+            return "?";
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdint.h>
+
+// Measures RSSI (dBm) with the radio tuned to freq_hz.
+typedef int (*FreqRefineProbe)(uint32_t freq_hz, void *ctx);
+
+enum FreqRefineStrategy : uint8_t {
+    // Every resolution step across the window: the historical baseline.
+    FREQ_REFINE_LINEAR = 0,
+    // Pattern search from the centre, halving the step when neither neighbour is better.
+    FREQ_REFINE_HILL_CLIMB,
+    // Three bracketing probes, then golden-section search around the best one.
+    FREQ_REFINE_GOLDEN_SECTION,
+    FREQ_REFINE_STRATEGY_COUNT,
+};
+
+// Search range [center - half_span, center + half_span]; strategies stop at resolution_hz.
+struct FreqRefineWindow {
+    uint32_t center_hz;
+    uint32_t half_span_hz;
+    uint32_t resolution_hz;
+};
+
+struct FreqRefineResult {
+    uint32_t freq_hz;
+    int rssi_dbm;
+    // Retunes actually issued; repeated frequencies are served from a small cache.
+    uint16_t probes;
+};
+
+// Returns the strongest frequency actually measured, never an extrapolated one.
+FreqRefineResult freq_refine(FreqRefineStrategy strategy,
+                             const FreqRefineWindow &window,
+                             FreqRefineProbe probe,
+                             void *ctx);
+const char *freq_refine_strategy_name(FreqRefineStrategy strategy);
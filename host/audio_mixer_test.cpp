@@ -0,0 +1,137 @@
+// AudioMixer driven in 64-frame chunks like audio_feedback_manager: a restarted sound and a
+// stolen voice must fade their cut clip out over one chunk instead of stepping the output,
+// and a stolen sound must still be reported finished.
+#include "audio_mixer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+
+constexpr uint32_t kChunk = 64;
+constexpr uint32_t kChunkUs = 4000;
+// A held clip level fading to zero over one chunk moves at most level / kChunk per sample.
+constexpr int kLevel = 4000;
+constexpr int kMaxStep = kLevel / static_cast<int>(kChunk) + 1;
+
+int failures = 0;
+
+void check(bool condition, const char *what) {
+    printf("  %-52s %s\n", what, condition ? "ok" : "ECHEC");
+    if (!condition) {
+        ++failures;
+    }
+}
+
+struct ChunkRun {
+    AudioMixer mixer;
+    uint32_t now_us = 0;
+    int16_t last = 0;
+    int worst_step = 0;
+
+    void mix_chunk() {
+        int16_t out[kChunk];
+        memset(out, 0, sizeof(out));
+        now_us += kChunkUs;
+        mixer.mix(out, kChunk, now_us);
+        for (uint32_t i = 0; i < kChunk; ++i) {
+            const int step = abs(out[i] - last);
+            worst_step = (step > worst_step) ? step : worst_step;
+            last = out[i];
+        }
+    }
+};
+
+void fill(int16_t *clip, uint32_t frames, int16_t level) {
+    for (uint32_t i = 0; i < frames; ++i) {
+        clip[i] = level;
+    }
+}
+
+void test_restart() {
+    printf("relance du meme son en cours de lecture:\n");
+    static int16_t held[kChunk * 10];
+    static int16_t silent_start[kChunk * 10];
+    fill(held, kChunk * 10, kLevel);
+    fill(silent_start, kChunk * 10, 0);
+
+    ChunkRun run;
+    run.mixer.start(0, held, kChunk * 10, AUDIO_PRIORITY_NORMAL, run.now_us);
+    run.mix_chunk();
+    run.mix_chunk();
+    run.worst_step = 0;
+    run.mixer.start(0, silent_start, kChunk * 10, AUDIO_PRIORITY_NORMAL, run.now_us);
+    run.mix_chunk();
+    run.mix_chunk();
+    printf("  saut max %d (fondu sur un bloc: %d)\n", run.worst_step, kMaxStep);
+    check(run.worst_step <= kMaxStep, "ancienne position fondue, pas de saut a zero");
+    check((run.mixer.take_finished() & 1UL) == 0, "relance non signalee comme terminee");
+    check(run.mixer.active(), "le son relance continue");
+}
+
+void test_steal() {
+    printf("voix volee par un son critique:\n");
+    static int16_t low[kChunk * 20];
+    static int16_t quiet[kChunk * 20];
+    fill(low, kChunk * 20, kLevel);
+    fill(quiet, kChunk * 20, 0);
+
+    // Every sound id busy; the critical start on id 3 marks 0..2 as stopping, and the second
+    // critical start, on id 1, finds no free slot and steals the first of them, id 0.
+    ChunkRun run;
+    run.mixer.start(0, low, kChunk * 20, AUDIO_PRIORITY_LOW, run.now_us);
+    run.mixer.start(1, quiet, kChunk * 20, AUDIO_PRIORITY_LOW, run.now_us);
+    run.mixer.start(2, quiet, kChunk * 20, AUDIO_PRIORITY_LOW, run.now_us);
+    run.mixer.start(3, quiet, kChunk * 20, AUDIO_PRIORITY_NORMAL, run.now_us);
+    run.mix_chunk();
+    run.mix_chunk();
+    run.mixer.take_finished();
+    run.worst_step = 0;
+
+    const bool critical = run.mixer.start(3, quiet, kChunk * 20, AUDIO_PRIORITY_CRITICAL, run.now_us);
+    const bool stolen = run.mixer.start(1, quiet, kChunk * 20, AUDIO_PRIORITY_CRITICAL, run.now_us);
+    run.mix_chunk();
+    const uint32_t finished = run.mixer.take_finished();
+    run.mix_chunk();
+    printf("  saut max %d (fondu sur un bloc: %d), termines 0x%X\n",
+           run.worst_step,
+           kMaxStep,
+           static_cast<unsigned>(finished));
+    check(critical && stolen, "deux sons critiques acceptes");
+    check(run.worst_step <= kMaxStep, "voix volee fondue sur un bloc");
+    check((finished & 0x7UL) == 0x7UL, "voix volee et voix preemptees terminees");
+    check(run.last == 0, "silence apres le fondu");
+}
+
+void test_steal_unstarted() {
+    printf("voix volee avant son premier echantillon:\n");
+    static int16_t quiet[kChunk * 4];
+    fill(quiet, kChunk * 4, 0);
+
+    ChunkRun run;
+    for (uint8_t id = 0; id < AUDIO_MIXER_MAX_SOUNDS; ++id) {
+        run.mixer.start(id, quiet, kChunk * 4, AUDIO_PRIORITY_LOW, run.now_us);
+    }
+    run.mixer.start(3, quiet, kChunk * 4, AUDIO_PRIORITY_CRITICAL, run.now_us);
+    run.mixer.start(1, quiet, kChunk * 4, AUDIO_PRIORITY_CRITICAL, run.now_us);
+    const uint32_t before_mix = run.mixer.take_finished();
+    run.mix_chunk();
+    const uint32_t after_mix = run.mixer.take_finished();
+    printf("  termines avant le bloc 0x%X, apres 0x%X\n",
+           static_cast<unsigned>(before_mix),
+           static_cast<unsigned>(after_mix));
+    check(((before_mix | after_mix) & 0x7UL) == 0x7UL, "sons jamais joues signales termines");
+    check(run.mixer.latency(0).count == 0 && run.mixer.latency(1).count == 1 && run.mixer.latency(3).count == 1,
+          "seuls les sons critiques demarrent");
+}
+
+}  // namespace
+
+int main() {
+    test_restart();
+    test_steal();
+    test_steal_unstarted();
+    printf(failures == 0 ? "OK\n" : "ECHEC\n");
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,199 @@
+// BatteryEstimator on synthetic millivolt traces, polled like battery_manager (a 16-sample
+// burst every 10 s): a steady discharge, RF load sag inside bursts, charging, and a voltage
+// hovering on an icon step boundary.
+#include "battery_estimator.h"
+
+#include <algorithm>
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t kPollMs = 10000;
+constexpr size_t kBurst = 16;
+
+int failures = 0;
+std::mt19937 rng(24);
+
+void check(bool condition, const char *what) {
+    printf("  %-56s %s\n", what, condition ? "ok" : "ECHEC");
+    if (!condition) {
+        ++failures;
+    }
+}
+
+// ADC noise on every sample; sagged samples drop by sag_mv (TX or amplifier load).
+void make_burst(uint16_t *out, float true_mv, int sagged, int sag_mv) {
+    std::uniform_int_distribution<int> noise(-10, 10);
+    for (size_t i = 0; i < kBurst; ++i) {
+        int mv = static_cast<int>(lroundf(true_mv)) + noise(rng);
+        if (static_cast<int>(i) < sagged) {
+            mv -= sag_mv;
+        }
+        out[i] = static_cast<uint16_t>(mv);
+    }
+    std::shuffle(out, out + kBurst, rng);
+}
+
+// Cell voltage at a state of charge, by inverting the estimator's own discharge curve.
+float mv_for_percent(float percent) {
+    uint16_t mv = 3400;
+    while (mv < 4200 && BatteryEstimator::percent_x10_from_mv(mv) < percent * 10.0f) {
+        ++mv;
+    }
+    return mv;
+}
+
+// Constant current: charge falls linearly, the voltage follows the discharge curve. The true
+// runtime is then the remaining charge over that constant rate.
+void test_steady_discharge() {
+    printf("decharge a courant constant 95%% -> 10%% en 4 h:\n");
+    constexpr uint32_t kDurationMs = 4UL * 3600UL * 1000UL;
+    constexpr float kStartPct = 95.0f;
+    constexpr float kEndPct = 10.0f;
+    constexpr float kPctPerMin = (kStartPct - kEndPct) / (kDurationMs / 60000.0f);
+    BatteryEstimator estimator;
+    uint32_t publishes = 0;
+    int worst_mv_error = 0;
+    float worst_runtime_error = 0.0f;
+    std::vector<float> runtime_errors;
+    uint32_t first_runtime_ms = 0;
+    for (uint32_t t = 0; t <= kDurationMs; t += kPollMs) {
+        const float percent = kStartPct - kPctPerMin * (t / 60000.0f);
+        const float mv = mv_for_percent(percent);
+        uint16_t burst[kBurst];
+        make_burst(burst, mv, 0, 0);
+        publishes += estimator.push_burst(burst, kBurst, t) ? 1 : 0;
+
+        const BatteryEstimate &now = estimator.current();
+        // After the EMA settled (a minute).
+        if (t >= 60000) {
+            const int error = abs(static_cast<int>(now.millivolts) - static_cast<int>(lroundf(mv)));
+            worst_mv_error = (error > worst_mv_error) ? error : worst_mv_error;
+        }
+        if (now.runtime_min != BATTERY_EST_RUNTIME_UNKNOWN) {
+            if (first_runtime_ms == 0) {
+                first_runtime_ms = t;
+            }
+            // Judged once the drain window is full.
+            if (t >= 32UL * 60000UL) {
+                const float reference_min = percent / kPctPerMin;
+                const float error = fabsf(static_cast<float>(now.runtime_min) - reference_min) / reference_min;
+                worst_runtime_error = (error > worst_runtime_error) ? error : worst_runtime_error;
+                runtime_errors.push_back(error);
+            }
+        }
+    }
+    std::sort(runtime_errors.begin(), runtime_errors.end());
+    const float median_runtime_error = runtime_errors.empty() ? 1.0f : runtime_errors[runtime_errors.size() / 2];
+    const uint32_t polls = kDurationMs / kPollMs + 1;
+    printf("  ecart max %d mV, autonomie connue a %.1f min, ecart median %.0f%% max %.0f%%, %u publications / %u mesures\n",
+           worst_mv_error,
+           first_runtime_ms / 60000.0f,
+           median_runtime_error * 100.0f,
+           worst_runtime_error * 100.0f,
+           publishes,
+           polls);
+    // The upper-half mean reads about half the noise amplitude high: ~5 mV here.
+    check(worst_mv_error <= 10, "tension filtree a 10 mV de la vraie");
+    check(first_runtime_ms > 0 && first_runtime_ms <= 10UL * 60000UL, "autonomie estimee en moins de 10 min");
+    check(median_runtime_error <= 0.10f, "autonomie mediane a 10% de la vraie");
+    // That bias is a constant offset in mV, but not in percent: where the drain window spans
+    // the 3840-3850 mV step (5% per 10 mV) against a flatter one, the drain reads ~2 points
+    // short of ~11 and the runtime up to a third long.
+    check(worst_runtime_error <= 0.40f, "autonomie a 40% de la vraie sur les coudes");
+    check(publishes <= polls / 10, "publications rares (pas a chaque mesure)");
+}
+
+void test_sag_rejection() {
+    printf("affaissement sous charge RF, 3900 mV:\n");
+    BatteryEstimator estimator;
+    std::uniform_int_distribution<int> sagged(0, kBurst / 2);
+    uint32_t publishes = 0;
+    int worst_mv = 0;
+    for (uint32_t t = 0; t <= 3600000; t += kPollMs) {
+        uint16_t burst[kBurst];
+        // Up to half of each burst taken while the radio or amplifier pulls 300 mV.
+        make_burst(burst, 3900.0f, sagged(rng), 300);
+        publishes += estimator.push_burst(burst, kBurst, t) ? 1 : 0;
+        const int error = abs(static_cast<int>(estimator.current().millivolts) - 3900);
+        worst_mv = (t > 0 && error > worst_mv) ? error : worst_mv;
+    }
+    printf("  ecart max %d mV, %u publications\n", worst_mv, publishes);
+    check(worst_mv <= 15, "tension filtree a 15 mV malgre les creux");
+    check(publishes <= 2, "aucune publication due aux creux");
+    check(estimator.estimate().runtime_min == BATTERY_EST_RUNTIME_UNKNOWN, "pas d'autonomie sur tension stable");
+}
+
+void test_charging() {
+    printf("charge 3700 -> 4150 mV en 1 h:\n");
+    BatteryEstimator estimator;
+    bool runtime_seen = false;
+    int last_published = -1;
+    bool monotonic = true;
+    for (uint32_t t = 0; t <= 3600000; t += kPollMs) {
+        uint16_t burst[kBurst];
+        make_burst(burst, 3700.0f + 450.0f * t / 3600000.0f, 0, 0);
+        if (estimator.push_burst(burst, kBurst, t)) {
+            const int percent = estimator.estimate().percent;
+            monotonic = monotonic && percent >= last_published;
+            last_published = percent;
+        }
+        runtime_seen = runtime_seen || estimator.current().runtime_min != BATTERY_EST_RUNTIME_UNKNOWN;
+    }
+    printf("  dernier pourcentage publie %d%%\n", last_published);
+    check(!runtime_seen, "aucune autonomie pendant la charge");
+    check(monotonic, "pourcentage publie croissant");
+    check(last_published >= 90, "pleine charge atteinte");
+}
+
+// 60% is the step between icons 2 and 3; hovering on it must not flicker the icon.
+void test_boundary_hysteresis() {
+    printf("tension sur le seuil d'icone 60%% (3870 mV):\n");
+    BatteryEstimator estimator;
+    uint32_t t = 0;
+    uint16_t burst[kBurst];
+    auto hold = [&](float mv, uint32_t duration_ms) {
+        int changes = 0;
+        int state = estimator.estimate().state;
+        for (uint32_t end = t + duration_ms; t < end; t += kPollMs) {
+            make_burst(burst, mv, 0, 0);
+            estimator.push_burst(burst, kBurst, t);
+            changes += (estimator.estimate().state != state) ? 1 : 0;
+            state = estimator.estimate().state;
+        }
+        return changes;
+    };
+
+    hold(3890.0f, 600000);
+    const int start_state = estimator.estimate().state;
+    // Triangle wave of +-6 mV around the boundary: about 59..61%.
+    int flicker = 0;
+    for (int cycle = 0; cycle < 30; ++cycle) {
+        flicker += hold(3876.0f, 60000);
+        flicker += hold(3864.0f, 60000);
+    }
+    printf("  etat %d au depart, %d changements en 60 min sur le seuil\n", start_state, flicker);
+    check(flicker <= 1, "icone stable sur le seuil");
+
+    hold(3840.0f, 600000);
+    const int low_state = estimator.estimate().state;
+    hold(3900.0f, 600000);
+    const int high_state = estimator.estimate().state;
+    printf("  50%% -> etat %d, 64%% -> etat %d\n", low_state, high_state);
+    check(low_state == 2 && high_state == 3, "franchissement net suivi dans les deux sens");
+}
+
+}  // namespace
+
+int main() {
+    test_steady_discharge();
+    test_sag_rejection();
+    test_charging();
+    test_boundary_hysteresis();
+    printf(failures ? "ECHEC\n" : "OK\n");
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
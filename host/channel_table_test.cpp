@@ -0,0 +1,67 @@
+// kSubGHzChannelTable against FREQ2/FREQ1/FREQ0 recomputed at run time from the datasheet
+// formula, f_carrier = f_xosc / 2^16 * FREQ[23:0], in double precision rather than through
+// the constexpr integer path that built the table.
+#include "cc1101_channel_table.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const char *what) {
+    printf("  %-52s %s\n", what, condition ? "ok" : "ECHEC");
+    if (!condition) {
+        ++failures;
+    }
+}
+
+}  // namespace
+
+int main() {
+    const double step_hz = static_cast<double>(CC1101_XOSC_HZ) / 65536.0;
+    printf("table des canaux, %zu entrees, pas de synthese %.1f Hz:\n", kSubGHzChannelTable.size(), step_hz);
+
+    bool sizes_match = kSubGHzChannelTable.size() == kSubGHzChannelCount;
+    bool order_kept = true;
+    bool words_match = true;
+    bool top_bits_clear = true;
+    double worst_error_hz = 0.0;
+    for (size_t i = 0; i < kSubGHzChannelCount; ++i) {
+        const Cc1101FreqWord &entry = kSubGHzChannelTable[i];
+        const uint32_t expected = static_cast<uint32_t>(llround(kSubGHzFrequencyList[i] / step_hz));
+        const uint32_t stored = (static_cast<uint32_t>(entry.freq2) << 16) |
+                                (static_cast<uint32_t>(entry.freq1) << 8) | entry.freq0;
+        if (entry.frequency_hz != kSubGHzFrequencyList[i]) {
+            order_kept = false;
+        }
+        if (stored != expected) {
+            words_match = false;
+            printf("  %u Hz: table %02X %02X %02X, attendu %02X %02X %02X\n",
+                   kSubGHzFrequencyList[i],
+                   entry.freq2,
+                   entry.freq1,
+                   entry.freq0,
+                   static_cast<unsigned>((expected >> 16) & 0xFF),
+                   static_cast<unsigned>((expected >> 8) & 0xFF),
+                   static_cast<unsigned>(expected & 0xFF));
+        }
+        // FREQ2[7:6] are always zero on the CC1101.
+        if (entry.freq2 & 0xC0) {
+            top_bits_clear = false;
+        }
+        const double error_hz = fabs(stored * step_hz - entry.frequency_hz);
+        worst_error_hz = (error_hz > worst_error_hz) ? error_hz : worst_error_hz;
+    }
+    printf("  ecart max entre porteuse synthetisee et demandee %.1f Hz\n", worst_error_hz);
+    check(sizes_match, "une entree par frequence de la liste");
+    check(order_kept, "ordre de kSubGHzFrequencyList conserve");
+    check(words_match, "FREQ2/FREQ1/FREQ0 identiques au calcul");
+    check(top_bits_clear, "FREQ2[7:6] a zero");
+    check(worst_error_hz <= step_hz / 2.0, "porteuse a un demi-pas de la demande");
+
+    printf(failures == 0 ? "OK\n" : "ECHEC\n");
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,102 @@
+// Synthetic RSSI envelopes through modulation_classify(), sampled like the modulation dwell
+// of cc1101_manager (64 readings over 4 ms): keyed OOK frames, constant-envelope FSK, and
+// noise alone, which must come out UNKNOWN rather than FSK.
+#include "modulation_classifier.h"
+
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace {
+
+constexpr uint16_t kSamples = 64;
+constexpr uint32_t kSampleUs = 4000 / kSamples;
+constexpr int kTrials = 500;
+constexpr int16_t kFloorDbm = -100;
+
+std::mt19937 rng(4242);
+
+int16_t reading(float dbm, float noise_db) {
+    std::uniform_real_distribution<float> noise(-noise_db, noise_db);
+    return static_cast<int16_t>(lroundf(dbm + noise(rng)));
+}
+
+// Princeton-style keying: each bit is 1 te on / 3 te off or 3 te on / 1 te off.
+void ook_envelope(int16_t *out, float on_dbm, uint32_t te_us) {
+    std::bernoulli_distribution bit(0.5);
+    uint32_t t_us = std::uniform_int_distribution<uint32_t>(0, 4 * te_us)(rng);
+    uint32_t bit_start_us = 0;
+    bool one = bit(rng);
+    for (uint16_t i = 0; i < kSamples; ++i, t_us += kSampleUs) {
+        while (t_us - bit_start_us >= 4 * te_us) {
+            bit_start_us += 4 * te_us;
+            one = bit(rng);
+        }
+        const bool on = (t_us - bit_start_us) < (one ? 3 : 1) * te_us;
+        out[i] = reading(on ? on_dbm : kFloorDbm, 1.5f);
+    }
+}
+
+void flat_envelope(int16_t *out, float dbm, float noise_db) {
+    for (uint16_t i = 0; i < kSamples; ++i) {
+        out[i] = reading(dbm, noise_db);
+    }
+}
+
+struct Case {
+    const char *name;
+    ModulationClass expected;
+    // Share of trials that must land on expected, in percent.
+    int min_pass_pct;
+};
+
+int run(const Case &test, void (*make)(int16_t *)) {
+    int pass = 0;
+    int16_t envelope[kSamples];
+    for (int t = 0; t < kTrials; ++t) {
+        make(envelope);
+        const ModulationDecision decision = modulation_classify(envelope, kSamples, kFloorDbm);
+        if (decision.modulation == test.expected) {
+            ++pass;
+        }
+        if (decision.modulation == MODULATION_UNKNOWN && decision.confidence_pct != 0) {
+            printf("  %s: UNKNOWN avec %u%%\n", test.name, static_cast<unsigned>(decision.confidence_pct));
+            return 1;
+        }
+    }
+    const int pct = pass * 100 / kTrials;
+    const bool ok = pct >= test.min_pass_pct;
+    printf("%-26s %-8s %3d%% (min %d%%)%s\n",
+           test.name,
+           modulation_class_name(test.expected),
+           pct,
+           test.min_pass_pct,
+           ok ? "" : " -> ECHEC");
+    return ok ? 0 : 1;
+}
+
+}  // namespace
+
+int main() {
+    int failures = 0;
+    failures += run({"OOK fort, te 350 us", MODULATION_ASK_OOK, 95}, [](int16_t *out) { ook_envelope(out, -50.0f, 350); });
+    failures += run({"OOK faible, te 350 us", MODULATION_ASK_OOK, 90}, [](int16_t *out) { ook_envelope(out, -85.0f, 350); });
+    failures += run({"OOK rapide, te 150 us", MODULATION_ASK_OOK, 90}, [](int16_t *out) { ook_envelope(out, -60.0f, 150); });
+    failures += run({"FSK fort", MODULATION_FSK, 99}, [](int16_t *out) { flat_envelope(out, -55.0f, 1.5f); });
+    failures += run({"FSK faible", MODULATION_FSK, 99}, [](int16_t *out) { flat_envelope(out, -88.0f, 1.5f); });
+    failures += run({"bruit seul", MODULATION_UNKNOWN, 100}, [](int16_t *out) { flat_envelope(out, kFloorDbm, 2.0f); });
+    failures += run({"porteuse sous la marge", MODULATION_UNKNOWN, 100}, [](int16_t *out) {
+        flat_envelope(out, kFloorDbm + MODULATION_MIN_CARRIER_DB - 3, 1.0f);
+    });
+
+    // Too few samples never yields a class.
+    int16_t short_burst[MODULATION_MIN_SAMPLES - 1] = {};
+    if (modulation_classify(short_burst, MODULATION_MIN_SAMPLES - 1, kFloorDbm).modulation != MODULATION_UNKNOWN) {
+        printf("rafale trop courte classee -> ECHEC\n");
+        ++failures;
+    }
+
+    printf(failures ? "ECHEC\n" : "OK\n");
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,260 @@
+// Throughput of OokDecoderEngine in pulses per second, and how many of the transmitted frames
+// it recovers. With a file argument the corpus is a recorded capture: signed durations in us,
+// positive = carrier on, as in the RAW_Data lines of a Flipper .sub file. Without one a corpus
+// of jittered Princeton, CAME, Nice FLO, PWM and Manchester frames separated by noise bursts
+// is generated, and every decoded frame is checked against what was sent.
+#include "ook_decoder.h"
+
+#include <chrono>
+#include <map>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct Pulse {
+    bool level;
+    uint32_t duration_us;
+};
+
+// Frames per protocol in the generated corpus.
+constexpr int kTransmissions = 400;
+// Remotes repeat their frame while the button is held.
+constexpr int kRepeats = 3;
+constexpr float kJitter = 0.10f;
+constexpr double kMinBenchSeconds = 1.0;
+
+using FrameKey = std::pair<std::string, uint64_t>;
+
+class CorpusBuilder {
+public:
+    explicit CorpusBuilder(uint32_t seed) : rng_(seed) {
+    }
+
+    std::vector<Pulse> pulses;
+    std::map<FrameKey, int> expected;
+
+    void princeton(uint32_t te, uint32_t code) {
+        add(false, 31 * te);
+        for (int r = 0; r < kRepeats; ++r) {
+            for (int i = 23; i >= 0; --i) {
+                const bool bit = (code >> i) & 1;
+                add(true, (bit ? 3 : 1) * te);
+                add(false, (bit ? 1 : 3) * te);
+            }
+            add(true, te);
+            add(false, 31 * te);
+            expect("Princeton", code);
+        }
+    }
+
+    // CAME and Nice FLO share the framing: header gap, start high, low/high pairs.
+    void came_like(const char *name, uint32_t te, uint32_t code, int bits) {
+        for (int r = 0; r < kRepeats; ++r) {
+            add(false, 36 * te);
+            add(true, te);
+            for (int i = bits - 1; i >= 0; --i) {
+                const bool bit = (code >> i) & 1;
+                add(false, (bit ? 2 : 1) * te);
+                add(true, (bit ? 1 : 2) * te);
+            }
+            expect(name, code);
+        }
+        add(false, 36 * te);
+    }
+
+    void manchester(uint32_t te, uint32_t code, int bits) {
+        add(false, 5000);
+        for (int i = bits - 1; i >= 0; --i) {
+            const bool bit = (code >> i) & 1;
+            add(bit, te);
+            add(!bit, te);
+        }
+        add(false, 5000);
+        expect("Manchester", code);
+    }
+
+    void pwm(uint32_t short_us, uint32_t code, int bits) {
+        add(false, 6000);
+        for (int i = bits - 1; i >= 0; --i) {
+            const bool bit = (code >> i) & 1;
+            add(true, bit ? 2 * short_us : short_us);
+            add(false, bit ? short_us : 2 * short_us);
+        }
+        add(false, 6000);
+        expect("PWM", code);
+    }
+
+    // Interference between transmissions: short random pulses no decoder should accept.
+    void noise(int count) {
+        std::uniform_int_distribution<uint32_t> duration(60, 1500);
+        for (int i = 0; i < count; ++i) {
+            add(i % 2 == 0, duration(rng_));
+        }
+    }
+
+    uint32_t random(uint32_t lo, uint32_t hi) {
+        return std::uniform_int_distribution<uint32_t>(lo, hi)(rng_);
+    }
+
+private:
+    std::mt19937 rng_;
+
+    void add(bool level, uint32_t duration_us) {
+        std::uniform_real_distribution<float> jitter(1.0f - kJitter, 1.0f + kJitter);
+        const uint32_t us = static_cast<uint32_t>(duration_us * jitter(rng_));
+        // Adjacent equal levels merge, as in a real capture.
+        if (!pulses.empty() && pulses.back().level == level) {
+            pulses.back().duration_us += us;
+        } else {
+            pulses.push_back({level, us});
+        }
+    }
+
+    void expect(const char *name, uint64_t payload) {
+        expected[{name, payload}]++;
+    }
+};
+
+bool load_recording(const char *path, std::vector<Pulse> *out) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+    char line[4096];
+    while (fgets(line, sizeof(line), file)) {
+        // Accept bare numbers as well as "RAW_Data: 350 -1050 ..." lines; skip other keys.
+        char *cursor = line;
+        if (const char *colon = strchr(line, ':')) {
+            if (strncmp(line, "RAW_Data", 8) != 0) {
+                continue;
+            }
+            cursor = const_cast<char *>(colon) + 1;
+        }
+        char *end = nullptr;
+        for (long value = strtol(cursor, &end, 10); end != cursor; value = strtol(cursor, &end, 10)) {
+            cursor = end;
+            if (value != 0) {
+                out->push_back({value > 0, static_cast<uint32_t>(value > 0 ? value : -value)});
+            }
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+std::vector<Pulse> generate(std::map<FrameKey, int> *expected) {
+    CorpusBuilder corpus(20240611);
+    for (int t = 0; t < kTransmissions; ++t) {
+        corpus.princeton(corpus.random(250, 500), corpus.random(0, 0xFFFFFF));
+        corpus.noise(40);
+        corpus.came_like("CAME", 320, corpus.random(0, 0xFFF), 12);
+        corpus.noise(40);
+        corpus.came_like("Nice FLO", 700, corpus.random(0, 0xFFF), 12);
+        corpus.noise(40);
+        corpus.manchester(corpus.random(300, 600), corpus.random(0x8000, 0xFFFF), 16);
+        corpus.noise(40);
+        corpus.pwm(corpus.random(300, 500), corpus.random(0x8000, 0xFFFFFF), 24);
+        corpus.noise(40);
+    }
+    *expected = corpus.expected;
+    return corpus.pulses;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    std::vector<Pulse> pulses;
+    std::map<FrameKey, int> expected;
+    if (argc > 1) {
+        if (!load_recording(argv[1], &pulses) || pulses.empty()) {
+            fprintf(stderr, "Lecture impossible: %s\n", argv[1]);
+            return EXIT_FAILURE;
+        }
+        printf("Corpus enregistre %s: %zu impulsions\n", argv[1], pulses.size());
+    } else {
+        pulses = generate(&expected);
+        printf("Corpus synthetique: %zu impulsions\n", pulses.size());
+    }
+    const std::map<FrameKey, int> sent = expected;
+    uint64_t air_us = 0;
+    for (const Pulse &pulse : pulses) {
+        air_us += pulse.duration_us;
+    }
+
+    // Decode pass: what comes out, and whether it was sent.
+    OokDecoderEngine engine;
+    std::map<std::string, int> decoded;
+    int unexpected = 0;
+    OokFrame frame;
+    auto drain = [&]() {
+        while (engine.pop_frame(&frame)) {
+            decoded[frame.protocol]++;
+            if (!expected.empty()) {
+                auto it = expected.find({frame.protocol, frame.payload});
+                if (it != expected.end() && it->second > 0) {
+                    it->second--;
+                } else {
+                    unexpected++;
+                }
+            }
+        }
+    };
+    for (const Pulse &pulse : pulses) {
+        engine.feed(pulse.level, pulse.duration_us);
+        drain();
+    }
+    engine.flush();
+    drain();
+
+    // Timed passes: feed and drain, as rf_task does after a capture.
+    engine.reset();
+    uint64_t fed = 0;
+    uint32_t frames = 0;
+    const auto start = std::chrono::steady_clock::now();
+    double seconds = 0.0;
+    do {
+        for (const Pulse &pulse : pulses) {
+            frames += engine.feed(pulse.level, pulse.duration_us);
+            while (engine.pop_frame(&frame)) {
+            }
+        }
+        fed += pulses.size();
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (seconds < kMinBenchSeconds);
+
+    printf("%.2f M impulsions/s, %.1f ns/impulsion, %.0fx le temps reel (%u trames)\n",
+           fed / seconds / 1e6,
+           seconds * 1e9 / fed,
+           (air_us * (fed / pulses.size()) / 1e6) / seconds,
+           frames);
+    for (const auto &entry : decoded) {
+        printf("  %-10s %d trames\n", entry.first.c_str(), entry.second);
+    }
+    if (expected.empty()) {
+        return EXIT_SUCCESS;
+    }
+
+    // Whatever is left in expected was sent but not decoded.
+    std::map<std::string, std::pair<int, int>> per_protocol;
+    for (const auto &entry : sent) {
+        per_protocol[entry.first.first].first += entry.second;
+    }
+    for (const auto &entry : expected) {
+        per_protocol[entry.first.first].second += entry.second;
+    }
+    int missed = 0;
+    for (const auto &entry : per_protocol) {
+        printf("  %-10s envoyees %d, manquees %d\n", entry.first.c_str(), entry.second.first, entry.second.second);
+        missed += entry.second.second;
+    }
+    // Unexpected frames are reported, not failed: 12-bit CAME has no check and the odd noise
+    // burst can spell one.
+    printf("manquees %d, inattendues %d\n", missed, unexpected);
+    return (missed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,121 @@
+// Frequency error of the sweep peak estimate on synthetic spectra: bin centre against the
+// parabolic interpolation of peak_finder, at the old 96-point and the current 32-point sweep.
+// Carriers follow the 200 kHz RX filter of the sweep profile (Gaussian, in dB), with noise
+// and the integer dBm rounding of the real RSSI readout.
+#include "peak_finder.h"
+
+#include <algorithm>
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+namespace {
+
+constexpr float kStartMhz = 433.05f;
+constexpr float kEndMhz = 434.79f;
+constexpr float kFilterFwhmMhz = 0.200f;
+constexpr float kNoiseFloorDbm = -100.0f;
+constexpr int kTrials = 20000;
+constexpr uint16_t kMaxSamples = 128;
+
+struct ErrorStats {
+    std::vector<float> khz;
+
+    void add(float error_mhz) {
+        khz.push_back(fabsf(error_mhz) * 1000.0f);
+    }
+    float mean() const {
+        double sum = 0.0;
+        for (float e : khz) {
+            sum += e;
+        }
+        return khz.empty() ? 0.0f : static_cast<float>(sum / khz.size());
+    }
+    float percentile(float p) {
+        if (khz.empty()) {
+            return 0.0f;
+        }
+        std::sort(khz.begin(), khz.end());
+        return khz[std::min(khz.size() - 1, static_cast<size_t>(p * khz.size()))];
+    }
+};
+
+// Carrier power seen at one tuning offset: filter shape in linear power, summed with the floor.
+float carrier_dbm(float offset_mhz, float peak_dbm) {
+    const float sigma = kFilterFwhmMhz / 2.3548f;
+    const float shape_db = -4.3429f * (offset_mhz * offset_mhz) / (2.0f * sigma * sigma);
+    const float signal_mw = powf(10.0f, (peak_dbm + shape_db) / 10.0f);
+    const float floor_mw = powf(10.0f, kNoiseFloorDbm / 10.0f);
+    return 10.0f * log10f(signal_mw + floor_mw);
+}
+
+void run(uint16_t samples, float noise_sigma_db, std::mt19937 &rng) {
+    std::uniform_real_distribution<float> freq_dist(kStartMhz + 0.1f, kEndMhz - 0.1f);
+    std::uniform_real_distribution<float> level_dist(-85.0f, -40.0f);
+    std::normal_distribution<float> noise(0.0f, noise_sigma_db > 0.0f ? noise_sigma_db : 1.0f);
+    const float step = (kEndMhz - kStartMhz) / (samples - 1);
+
+    ErrorStats bin_error;
+    ErrorStats interp_error;
+    ErrorStats level_error;
+    int misses = 0;
+    int16_t rssi[kMaxSamples];
+    for (int t = 0; t < kTrials; ++t) {
+        const float carrier_mhz = freq_dist(rng);
+        const float level_dbm = level_dist(rng);
+        for (uint16_t i = 0; i < samples; ++i) {
+            const float f = kStartMhz + i * step;
+            rssi[i] = static_cast<int16_t>(lroundf(carrier_dbm(f - carrier_mhz, level_dbm) + (noise_sigma_db > 0.0f ? noise(rng) : 0.0f)));
+        }
+
+        SpectrumPeak peak;
+        if (peak_find_top_k(rssi, samples, kStartMhz, step, -95, 3, &peak, 1) == 0) {
+            ++misses;
+            continue;
+        }
+        bin_error.add(kStartMhz + peak.bin * step - carrier_mhz);
+        interp_error.add(peak.freq_mhz - carrier_mhz);
+        level_error.khz.push_back(fabsf(peak.rssi_dbm - level_dbm));
+    }
+
+    printf("%3u points (pas %5.1f kHz): bin moy %5.1f p95 %5.1f kHz | interpole moy %5.1f p95 %5.1f kHz"
+           " | RSSI moy %.2f dB | manques %d\n",
+           static_cast<unsigned>(samples),
+           step * 1000.0f,
+           bin_error.mean(),
+           bin_error.percentile(0.95f),
+           interp_error.mean(),
+           interp_error.percentile(0.95f),
+           level_error.mean(),
+           misses);
+}
+
+}  // namespace
+
+// A flat step on a rising flank must not be reported as a second emitter.
+bool check_flank_plateau() {
+    const int16_t rssi[] = {-100, -100, -100, -90, -80, -80, -60, -50, -60, -80, -100, -100};
+    constexpr uint16_t kCount = sizeof(rssi) / sizeof(rssi[0]);
+    SpectrumPeak peaks[4];
+    const uint8_t found = peak_find_top_k(rssi, kCount, 0.0f, 1.0f, -95, 1, peaks, 4);
+    const bool ok = (found == 1 && peaks[0].bin == 7);
+    printf("palier sur flanc: %u pic(s)%s\n", static_cast<unsigned>(found), ok ? "" : " -> ECHEC");
+    return ok;
+}
+
+int main() {
+    if (!check_flank_plateau()) {
+        return EXIT_FAILURE;
+    }
+    std::mt19937 rng(12345);
+    // Without noise only the bin grid and the dBm rounding limit the estimate.
+    for (float sigma_db : {0.0f, 1.0f}) {
+        printf("%d spectres par resolution, bruit %.1f dB, filtre %.0f kHz\n", kTrials, sigma_db, kFilterFwhmMhz * 1000.0f);
+        for (uint16_t samples : {96, 64, 32}) {
+            run(samples, sigma_db, rng);
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,154 @@
+// PulseBufferPool with injected pulses: blocks filled through pulse_block_encode() as the RMT
+// would, then acquire/commit/take/release, the pool running dry, the stale READY drain that
+// rf_capture_manager_arm() performs, and a producer thread committing while a consumer takes.
+#include "pulse_buffer_pool.h"
+
+#include <atomic>
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+
+namespace {
+
+constexpr uint8_t kBlocks = 4;
+constexpr uint16_t kSymbols = 16;
+constexpr uint32_t kThreadedBlocks = 200000;
+
+uint32_t storage[kBlocks * kSymbols];
+int failures = 0;
+
+void check(bool condition, const char *what) {
+    if (!condition) {
+        printf("  ECHEC: %s\n", what);
+        ++failures;
+    }
+}
+
+// Producer side of one capture: acquire, encode, commit.
+PulseBlock *inject(PulseBufferPool &pool, const uint16_t *durations, uint16_t count, uint32_t tag) {
+    PulseBlock *block = pool.acquire();
+    if (!block) {
+        return nullptr;
+    }
+    block->frequency_hz = tag;
+    pulse_block_encode(block, durations, true, count);
+    pool.commit(block, block->symbol_count, tag);
+    return block;
+}
+
+void test_round_trip() {
+    PulseBufferPool pool;
+    check(pool.init(storage, kBlocks, kSymbols), "init");
+
+    // Odd count: the last symbol keeps a zero second half, which ends the train.
+    const uint16_t durations[] = {350, 1050, 40000, 350, 10850};
+    check(inject(pool, durations, 5, 1) != nullptr, "injection");
+    PulseBlock *block = pool.take_ready();
+    check(block && block->frequency_hz == 1, "bloc pret");
+    if (block) {
+        const PulseTrain train(*block);
+        check(train.size() == 5, "5 impulsions");
+        check(train.level(0) && !train.level(1) && train.level(2), "niveaux alternes");
+        check(train.duration_us(0) == 350 && train.duration_us(1) == 1050, "durees");
+        check(train.duration_us(2) == PULSE_MAX_DURATION_US, "duree saturee a 15 bits");
+        check(train.duration_us(5) == 0, "hors train");
+        pool.release(block);
+    }
+    check(pool.count_in_state(PULSE_BLOCK_FREE) == kBlocks, "tout libere");
+}
+
+void test_order_and_exhaustion() {
+    PulseBufferPool pool;
+    pool.init(storage, kBlocks, kSymbols);
+    const uint16_t durations[] = {500, 500};
+    for (uint32_t i = 0; i < kBlocks; ++i) {
+        check(inject(pool, durations, 2, 10 + i) != nullptr, "injection");
+    }
+    check(pool.acquire() == nullptr, "pool epuise");
+    for (uint32_t i = 0; i < kBlocks; ++i) {
+        PulseBlock *block = pool.take_ready();
+        check(block && block->frequency_hz == 10 + i, "plus ancien d'abord");
+        pool.release(block);
+    }
+    check(pool.take_ready() == nullptr, "plus rien de pret");
+
+    PulseBlock *block = pool.acquire();
+    pool.abandon(block);
+    check(pool.count_in_state(PULSE_BLOCK_FREE) == kBlocks, "abandon libere");
+}
+
+// rf_capture_manager: take() timed out, the receive completed before disarm(), so a READY
+// block of the previous frequency waits in the pool. arm() must drop it before waiting again.
+void test_stale_ready_drain() {
+    PulseBufferPool pool;
+    pool.init(storage, kBlocks, kSymbols);
+    const uint16_t durations[] = {300, 900};
+
+    PulseBlock *armed = pool.acquire();
+    armed->frequency_hz = 433920000;
+    check(pool.take_ready() == nullptr, "delai ecoule sans trame");
+    pulse_block_encode(armed, durations, true, 2);
+    pool.commit(armed, armed->symbol_count, 0);
+
+    check(pool.discard_ready() == 1, "trame perimee ecartee");
+    check(inject(pool, durations, 2, 868350000) != nullptr, "nouvelle capture");
+    PulseBlock *block = pool.take_ready();
+    check(block && block->frequency_hz == 868350000, "seule la nouvelle frequence sort");
+    pool.release(block);
+    check(pool.discard_ready() == 0, "rien a ecarter");
+}
+
+// commit() runs from the RMT ISR on target: a producer thread stands in for it.
+void test_threaded() {
+    PulseBufferPool pool;
+    pool.init(storage, kBlocks, kSymbols);
+    std::atomic<bool> done{false};
+
+    std::thread producer([&]() {
+        uint16_t durations[2];
+        for (uint32_t i = 1; i <= kThreadedBlocks;) {
+            durations[0] = static_cast<uint16_t>(1 + i % PULSE_MAX_DURATION_US);
+            durations[1] = static_cast<uint16_t>(1 + (i * 7) % PULSE_MAX_DURATION_US);
+            if (inject(pool, durations, 2, i)) {
+                ++i;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    uint32_t expected = 1;
+    uint32_t bad = 0;
+    for (;;) {
+        const bool finished = done.load(std::memory_order_acquire);
+        PulseBlock *block = pool.take_ready();
+        if (!block) {
+            if (finished) {
+                break;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+        const PulseTrain train(*block);
+        const uint32_t tag = block->frequency_hz;
+        bad += (tag != expected) ? 1 : 0;
+        bad += (train.size() != 2 || train.duration_us(0) != 1 + tag % PULSE_MAX_DURATION_US) ? 1 : 0;
+        expected = tag + 1;
+        pool.release(block);
+    }
+    producer.join();
+    printf("  %u blocs via deux threads, %u anomalies\n", kThreadedBlocks, bad);
+    check(bad == 0 && expected == kThreadedBlocks + 1, "ordre et contenu sous concurrence");
+}
+
+}  // namespace
+
+int main() {
+    test_round_trip();
+    test_order_and_exhaustion();
+    test_stale_ready_drain();
+    test_threaded();
+    printf(failures ? "ECHEC\n" : "OK\n");
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
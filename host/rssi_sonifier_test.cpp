@@ -0,0 +1,179 @@
+// RssiSonifier rendered in 64-frame chunks at 16 kHz, as the audio mixer drives it:
+// publish-to-audible latency, phase continuity across chunk boundaries, and the Geiger click
+// rate against the rate mapped from RSSI.
+#include "rssi_sonifier.h"
+
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t kSampleRate = 16000;
+constexpr uint32_t kChunk = 64;
+constexpr float kPi = 3.14159265f;
+
+int failures = 0;
+
+void check(bool condition, const char *what) {
+    printf("  %-52s %s\n", what, condition ? "ok" : "ECHEC");
+    if (!condition) {
+        ++failures;
+    }
+}
+
+std::vector<int16_t> render_chunks(RssiSonifier &sonifier, uint32_t chunks) {
+    std::vector<int16_t> out(chunks * kChunk);
+    for (uint32_t c = 0; c < chunks; ++c) {
+        sonifier.render(out.data() + c * kChunk, kChunk);
+    }
+    return out;
+}
+
+// Mean frequency from the first to the last rising zero crossing, interpolated between samples.
+float measure_hz(const std::vector<int16_t> &samples) {
+    float first = -1.0f;
+    float last = -1.0f;
+    int crossings = 0;
+    for (size_t i = 1; i < samples.size(); ++i) {
+        if (samples[i - 1] < 0 && samples[i] >= 0) {
+            const float t = (i - 1) + static_cast<float>(-samples[i - 1]) / (samples[i] - samples[i - 1]);
+            if (first < 0.0f) {
+                first = t;
+            }
+            last = t;
+            ++crossings;
+        }
+    }
+    return (crossings > 1) ? (crossings - 1) * kSampleRate / (last - first) : 0.0f;
+}
+
+float mapped_pitch(const SonifierConfig &config, int rssi_dbm) {
+    const float level = static_cast<float>(rssi_dbm - config.rssi_min_dbm) / (config.rssi_max_dbm - config.rssi_min_dbm);
+    return config.pitch_min_hz * powf(static_cast<float>(config.pitch_max_hz) / config.pitch_min_hz, level);
+}
+
+void test_latency() {
+    printf("latence publication -> audible:\n");
+    const SonifierConfig config = RssiSonifier::default_config(kSampleRate);
+    // Two sonifiers in lockstep; only one of them sees the new RSSI.
+    RssiSonifier moved;
+    RssiSonifier steady;
+    for (RssiSonifier *s : {&moved, &steady}) {
+        s->configure(config);
+        s->set_mode(SONIFY_PITCH);
+        s->publish_rssi(-90);
+        render_chunks(*s, 10);
+    }
+    moved.publish_rssi(-40);
+    const std::vector<int16_t> first_moved = render_chunks(moved, 1);
+    const std::vector<int16_t> first_steady = render_chunks(steady, 1);
+    check(memcmp(first_moved.data(), first_steady.data(), kChunk * sizeof(int16_t)) != 0,
+          "le premier bloc apres publication change deja");
+
+    // From the second chunk on the tone sits at the new pitch: the glide fit in one chunk.
+    const float hz = measure_hz(render_chunks(moved, 10));
+    const float target = mapped_pitch(config, -40);
+    printf("  cible %.0f Hz, mesure %.0f Hz des le 2e bloc\n", target, hz);
+    check(fabsf(hz - target) <= 0.01f * target, "hauteur atteinte en un bloc (1%)");
+
+    // From silence: the first chunk after the publish is audible.
+    RssiSonifier muted;
+    muted.configure(config);
+    muted.set_mode(SONIFY_PITCH);
+    muted.publish_rssi(config.rssi_min_dbm - 10);
+    const std::vector<int16_t> silent = render_chunks(muted, 4);
+    bool all_zero = true;
+    for (int16_t v : silent) {
+        all_zero = all_zero && v == 0;
+    }
+    check(all_zero, "muet sous le minimum");
+    muted.publish_rssi(-60);
+    const std::vector<int16_t> onset = render_chunks(muted, 1);
+    int peak = 0;
+    for (int16_t v : onset) {
+        peak = (abs(v) > peak) ? abs(v) : peak;
+    }
+    check(peak > config.gain_q15 / 4, "son audible dans le premier bloc depuis le silence");
+}
+
+// Largest sample step across chunk boundaries against the steepest slope a sine of the
+// highest pitch played can have. Pitches stay in the lower half of the range, where a phase
+// reset or jump (up to the full amplitude) is well above that slope.
+void test_phase_continuity() {
+    printf("continuite de phase:\n");
+    const SonifierConfig config = RssiSonifier::default_config(kSampleRate);
+    RssiSonifier sonifier;
+    sonifier.configure(config);
+    sonifier.set_mode(SONIFY_PITCH);
+
+    std::mt19937 rng(5);
+    constexpr int kTopDbm = -65;
+    std::uniform_int_distribution<int> rssi(config.rssi_min_dbm + 1, kTopDbm);
+    const float max_slope = config.gain_q15 * 2.0f * kPi * mapped_pitch(config, kTopDbm) / kSampleRate;
+    int16_t previous_last = 0;
+    float worst_boundary = 0.0f;
+    for (int c = 0; c < 4000; ++c) {
+        // New RSSI every chunk: pitch glides never stop.
+        sonifier.publish_rssi(rssi(rng));
+        int16_t chunk[kChunk];
+        sonifier.render(chunk, kChunk);
+        if (c > 0) {
+            const float step = fabsf(static_cast<float>(chunk[0]) - previous_last);
+            worst_boundary = (step > worst_boundary) ? step : worst_boundary;
+        }
+        previous_last = chunk[kChunk - 1];
+    }
+    printf("  pire saut en frontiere %.0f, pente max d'un sinus %.0f\n", worst_boundary, max_slope);
+    check(worst_boundary <= 1.05f * max_slope, "aucun saut de phase entre blocs");
+}
+
+// Click onsets: a burst after at least 1 ms of quiet. The 2 ms decay plus that 1 ms hide a
+// click that follows within ~3 ms, so rates stay low enough for overlaps to be rare.
+void test_click_rate() {
+    printf("cadence des clics:\n");
+    const SonifierConfig config = RssiSonifier::default_config(kSampleRate);
+    constexpr uint32_t kSeconds = 300;
+    constexpr int kOnsetLevel = 1000;
+    constexpr int kQuietLevel = 100;
+    constexpr uint32_t kQuietFrames = kSampleRate / 1000;
+
+    for (int rssi_dbm : {-100, -80, -65, -55}) {
+        RssiSonifier sonifier;
+        sonifier.configure(config);
+        sonifier.set_mode(SONIFY_CLICKS);
+        sonifier.publish_rssi(rssi_dbm);
+
+        uint32_t onsets = 0;
+        uint32_t quiet = kQuietFrames;
+        int16_t chunk[kChunk];
+        for (uint32_t c = 0; c < kSeconds * kSampleRate / kChunk; ++c) {
+            sonifier.render(chunk, kChunk);
+            for (int16_t v : chunk) {
+                if (abs(v) >= kOnsetLevel && quiet >= kQuietFrames) {
+                    ++onsets;
+                }
+                quiet = (abs(v) < kQuietLevel) ? quiet + 1 : 0;
+            }
+        }
+        const float target = sonifier.click_rate_mhz() / 1000.0f;
+        const float measured = static_cast<float>(onsets) / kSeconds;
+        char label[64];
+        snprintf(label, sizeof(label), "%d dBm: cible %.2f/s, mesure %.2f/s", rssi_dbm, target, measured);
+        // Poisson spread over 300 s plus the few hidden overlaps at the highest rate.
+        check(fabsf(measured - target) <= 0.08f * target + 3.0f * sqrtf(target / kSeconds), label);
+    }
+}
+
+}  // namespace
+
+int main() {
+    test_latency();
+    test_phase_continuity();
+    test_click_rate();
+    printf(failures ? "ECHEC\n" : "OK\n");
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
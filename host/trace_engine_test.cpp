@@ -0,0 +1,101 @@
+// The scalar trace kernels are the mirrors the PIE path is checked against on the board
+// (trace_engine_self_test at boot). Here they are compared with a lane-by-lane model of the
+// PIE instructions used by the vector path (EE.VMAX/VMIN.S16, EE.VSUBS/VADDS.S16 saturating,
+// EE.VMUL.S16 with SAR = 15), on random traces including saturation and scalar tails.
+#include "trace_engine.h"
+
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+namespace {
+
+constexpr int kRounds = 2000;
+constexpr size_t kLanes = 8;
+
+int16_t sat(int32_t v) {
+    return static_cast<int16_t>(v > INT16_MAX ? INT16_MAX : (v < INT16_MIN ? INT16_MIN : v));
+}
+
+// One 8-lane block as the PIE sequence computes it.
+void pie_ema_block(int16_t *acc, const int16_t *x, int16_t alpha_q15) {
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        const int16_t diff = sat(static_cast<int32_t>(x[lane]) - acc[lane]);
+        // EE.VMUL.S16: 32-bit product arithmetic-shifted right by SAR, low 16 bits kept.
+        const int16_t step = static_cast<int16_t>((static_cast<int32_t>(diff) * alpha_q15) >> 15);
+        acc[lane] = sat(static_cast<int32_t>(acc[lane]) + step);
+    }
+}
+
+// Whole blocks through the lane model, the tail through the same per-element rule.
+void reference_ema(int16_t *acc, const int16_t *x, size_t n, int16_t alpha_q15) {
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        pie_ema_block(acc + i, x + i, alpha_q15);
+    }
+    for (; i < n; ++i) {
+        int16_t tail_acc[kLanes] = {acc[i]};
+        int16_t tail_x[kLanes] = {x[i]};
+        pie_ema_block(tail_acc, tail_x, alpha_q15);
+        acc[i] = tail_acc[0];
+    }
+}
+
+}  // namespace
+
+int main() {
+    std::mt19937 rng(8);
+    std::uniform_int_distribution<int> full(INT16_MIN, INT16_MAX);
+    std::uniform_int_distribution<int> dbm_q4(-130 * 16, -20 * 16);
+    std::uniform_int_distribution<size_t> length(1, TRACE_MAX_BINS);
+    std::uniform_int_distribution<int> alpha(0, INT16_MAX);
+
+    int failures = 0;
+    std::vector<int16_t> x;
+    std::vector<int16_t> acc;
+    std::vector<int16_t> expected;
+    for (int round = 0; round < kRounds && failures == 0; ++round) {
+        const size_t n = length(rng);
+        const bool full_range = (round & 1) != 0;
+        x.resize(n);
+        acc.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            x[i] = static_cast<int16_t>(full_range ? full(rng) : dbm_q4(rng));
+            acc[i] = static_cast<int16_t>(full_range ? full(rng) : dbm_q4(rng));
+        }
+        // Edge alphas every few rounds.
+        const int16_t a = (round % 5 == 0) ? INT16_MAX : (round % 7 == 0) ? 0 : static_cast<int16_t>(alpha(rng));
+
+        expected = acc;
+        reference_ema(expected.data(), x.data(), n, a);
+        std::vector<int16_t> got = acc;
+        trace_ema_s16_scalar(got.data(), x.data(), n, a);
+        if (memcmp(got.data(), expected.data(), n * sizeof(int16_t)) != 0) {
+            printf("ema: ecart (n %zu, alpha %d)\n", n, a);
+            ++failures;
+        }
+
+        got = acc;
+        trace_max_s16_scalar(got.data(), x.data(), n);
+        for (size_t i = 0; i < n; ++i) {
+            failures += (got[i] != (x[i] > acc[i] ? x[i] : acc[i])) ? 1 : 0;
+        }
+        got = acc;
+        trace_min_s16_scalar(got.data(), x.data(), n);
+        for (size_t i = 0; i < n; ++i) {
+            failures += (got[i] != (x[i] < acc[i] ? x[i] : acc[i])) ? 1 : 0;
+        }
+    }
+    printf("%d traces aleatoires, scalaire vs modele PIE: %s\n", kRounds, failures ? "ECART" : "identiques");
+
+    // Same self-test as the board runs; on the host both sides take the scalar path.
+    if (!trace_engine_self_test()) {
+        printf("auto-test: ECHEC\n");
+        ++failures;
+    }
+
+    printf(failures ? "ECHEC\n" : "OK\n");
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
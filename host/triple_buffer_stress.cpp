@@ -0,0 +1,92 @@
+// Two-thread stress test of TripleBuffer: the producer publishes frames whose every sample
+// carries the frame sequence number, the consumer checks each frame it reads is whole and
+// never older than the previous one. Exits non-zero on a torn or stale frame.
+#include "triple_buffer.h"
+
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+
+namespace {
+
+// Same order of size as a sweep frame; large enough that a torn copy would show.
+constexpr uint16_t kSamples = 256;
+constexpr uint32_t kFrames = 2000000;
+// Both threads yield part-way through a frame now and then, so the interleavings also happen
+// on a single-core host where the threads would otherwise only switch at time-slice ends.
+constexpr uint32_t kProducerYieldEvery = 16;
+
+struct Frame {
+    uint32_t sequence;
+    uint16_t sample_count;
+    int16_t samples[kSamples];
+    uint32_t sequence_tail;
+};
+
+TripleBuffer<Frame> buffer;
+std::atomic<bool> producer_done{false};
+
+void produce() {
+    for (uint32_t seq = 1; seq <= kFrames; ++seq) {
+        Frame &frame = buffer.write_slot();
+        frame.sequence = seq;
+        frame.sample_count = static_cast<uint16_t>(1 + seq % kSamples);
+        const uint16_t yield_at = (seq % kProducerYieldEvery == 0) ? seq / kProducerYieldEvery % kSamples : kSamples;
+        for (uint16_t i = 0; i < kSamples; ++i) {
+            if (i == yield_at) {
+                std::this_thread::yield();
+            }
+            frame.samples[i] = static_cast<int16_t>(seq + i);
+        }
+        frame.sequence_tail = seq;
+        buffer.publish();
+    }
+    producer_done.store(true, std::memory_order_release);
+}
+
+}  // namespace
+
+int main() {
+    const auto start = std::chrono::steady_clock::now();
+    std::thread producer(produce);
+
+    uint32_t frames_read = 0;
+    uint32_t torn = 0;
+    uint32_t stale = 0;
+    uint32_t last_seq = 0;
+    for (;;) {
+        // Read the done flag first so the last publish is always seen by the final consume().
+        const bool done = producer_done.load(std::memory_order_acquire);
+        if (buffer.consume()) {
+            const Frame &frame = buffer.read_slot();
+            bool whole = (frame.sequence == frame.sequence_tail) &&
+                         (frame.sample_count == 1 + frame.sequence % kSamples);
+            const uint16_t yield_at = frames_read % kSamples;
+            for (uint16_t i = 0; i < kSamples && whole; ++i) {
+                if (i == yield_at) {
+                    std::this_thread::yield();
+                }
+                whole = (frame.samples[i] == static_cast<int16_t>(frame.sequence + i));
+            }
+            torn += whole ? 0 : 1;
+            stale += (frame.sequence <= last_seq) ? 1 : 0;
+            last_seq = frame.sequence;
+            ++frames_read;
+        } else if (done) {
+            break;
+        }
+    }
+    producer.join();
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%u trames publiees, %u lues, derniere #%u, %.2f s\n", kFrames, frames_read, last_seq, seconds);
+    printf("dechirees: %u, perimees: %u\n", torn, stale);
+    if (torn != 0 || stale != 0 || last_seq != kFrames) {
+        printf("ECHEC\n");
+        return EXIT_FAILURE;
+    }
+    printf("OK\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,148 @@
+#include "input_manager.h"
+
+#include "freertos/queue.h"
+
+namespace {
+
+// Contact bounce of the tactile buttons settles well within this.
+constexpr uint32_t kDebounceMs = 30;
+constexpr UBaseType_t kEventQueueDepth = 16;
+
+struct ButtonState {
+    bool configured;
+    gpio_num_t gpio;
+    uint32_t long_press_ms;
+    // Written by the ISR under g_input_mux.
+    volatile bool edge_pending;
+    volatile uint32_t first_edge_ms;
+    volatile uint32_t last_edge_ms;
+    // Task side.
+    bool pressed;
+    bool long_reported;
+    uint32_t pressed_since_ms;
+};
+
+ButtonState g_buttons[INPUT_BUTTON_COUNT] = {};
+TaskHandle_t g_notify_task = nullptr;
+QueueHandle_t g_event_queue = nullptr;
+portMUX_TYPE g_input_mux = portMUX_INITIALIZER_UNLOCKED;
+
+void IRAM_ATTR button_isr(void *arg) {
+    ButtonState *button = static_cast<ButtonState *>(arg);
+    const uint32_t now_ms = millis();
+    portENTER_CRITICAL_ISR(&g_input_mux);
+    if (!button->edge_pending) {
+        button->first_edge_ms = now_ms;
+        button->edge_pending = true;
+    }
+    button->last_edge_ms = now_ms;
+    portEXIT_CRITICAL_ISR(&g_input_mux);
+
+    BaseType_t woken = pdFALSE;
+    if (g_notify_task) {
+        vTaskNotifyGiveFromISR(g_notify_task, &woken);
+    }
+    portYIELD_FROM_ISR(woken);
+}
+
+void push_event(InputButton button, InputEventType type, uint32_t timestamp_ms) {
+    const InputEvent event = {button, type, timestamp_ms};
+    if (xQueueSend(g_event_queue, &event, 0) != pdTRUE) {
+        Serial.println("[INPUT] file d'evenements pleine");
+    }
+}
+
+uint32_t min_wait(uint32_t a, uint32_t b) {
+    return (a < b) ? a : b;
+}
+
+}  // namespace
+
+bool input_manager_init(TaskHandle_t notify_task) {
+    if (g_event_queue) {
+        return true;
+    }
+    g_event_queue = xQueueCreate(kEventQueueDepth, sizeof(InputEvent));
+    if (!g_event_queue) {
+        Serial.println("[INPUT] Erreur creation file");
+        return false;
+    }
+    g_notify_task = notify_task;
+    return true;
+}
+
+bool input_manager_add_button(InputButton button, gpio_num_t gpio, uint32_t long_press_ms) {
+    if (button >= INPUT_BUTTON_COUNT || !g_event_queue) {
+        return false;
+    }
+    ButtonState &state = g_buttons[button];
+    pinMode(gpio, INPUT_PULLUP);
+    state.gpio = gpio;
+    state.long_press_ms = long_press_ms;
+    state.edge_pending = false;
+    state.pressed = (digitalRead(gpio) == LOW);
+    state.long_reported = true;  // A button already held at boot is not a long press.
+    state.pressed_since_ms = millis();
+    state.configured = true;
+    attachInterruptArg(digitalPinToInterrupt(gpio), button_isr, &state, CHANGE);
+    return true;
+}
+
+uint32_t input_manager_service(uint32_t now_ms) {
+    uint32_t wait_ms = UINT32_MAX;
+    for (uint8_t i = 0; i < INPUT_BUTTON_COUNT; ++i) {
+        ButtonState &state = g_buttons[i];
+        if (!state.configured) {
+            continue;
+        }
+        const InputButton button = static_cast<InputButton>(i);
+
+        // Sample the level once the line has been quiet for the debounce time.
+        portENTER_CRITICAL(&g_input_mux);
+        const bool edge_pending = state.edge_pending;
+        const uint32_t first_edge_ms = state.first_edge_ms;
+        const uint32_t quiet_ms = now_ms - state.last_edge_ms;
+        if (edge_pending && quiet_ms >= kDebounceMs) {
+            state.edge_pending = false;
+        }
+        portEXIT_CRITICAL(&g_input_mux);
+
+        if (edge_pending) {
+            if (quiet_ms < kDebounceMs) {
+                wait_ms = min_wait(wait_ms, kDebounceMs - quiet_ms);
+            } else {
+                const bool pressed = (digitalRead(state.gpio) == LOW);
+                if (pressed != state.pressed) {
+                    state.pressed = pressed;
+                    if (pressed) {
+                        state.pressed_since_ms = first_edge_ms;
+                        state.long_reported = false;
+                    }
+                    push_event(button, pressed ? INPUT_EVENT_PRESS : INPUT_EVENT_RELEASE, first_edge_ms);
+                }
+            }
+        }
+
+        if (state.pressed && !state.long_reported && state.long_press_ms > 0) {
+            const uint32_t held_ms = now_ms - state.pressed_since_ms;
+            if (held_ms >= state.long_press_ms) {
+                state.long_reported = true;
+                push_event(button, INPUT_EVENT_LONG_PRESS, now_ms);
+            } else {
+                wait_ms = min_wait(wait_ms, state.long_press_ms - held_ms);
+            }
+        }
+    }
+    return wait_ms;
+}
+
+bool input_manager_get_event(InputEvent *out_event) {
+    if (!out_event || !g_event_queue) {
+        return false;
+    }
+    return xQueueReceive(g_event_queue, out_event, 0) == pdTRUE;
+}
+
+bool input_manager_is_pressed(InputButton button) {
+    return button < INPUT_BUTTON_COUNT && g_buttons[button].pressed;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include <Arduino.h>
+#include <stdint.h>
+
+enum InputButton : uint8_t {
+    INPUT_BUTTON_POWER = 0,
+    INPUT_BUTTON_BOOT,
+    INPUT_BUTTON_COUNT,
+};
+
+enum InputEventType : uint8_t {
+    INPUT_EVENT_PRESS = 0,
+    INPUT_EVENT_RELEASE,
+    // Held for the button's long-press duration; sent once per press.
+    INPUT_EVENT_LONG_PRESS,
+};
+
+struct InputEvent {
+    InputButton button;
+    InputEventType type;
+    // First edge of the debounced transition (millis()), or the long-press instant.
+    uint32_t timestamp_ms;
+};
+
+// Active-low buttons on GPIO edge interrupts. ISRs only timestamp the edge and notify
+// notify_task; debounce and long-press timing run in that task through input_manager_service().
+bool input_manager_init(TaskHandle_t notify_task);
+bool input_manager_add_button(InputButton button, gpio_num_t gpio, uint32_t long_press_ms);
+
+// Turns settled edges into events. Returns the ms until it needs to run again
+// (pending debounce or long-press), or UINT32_MAX when nothing is pending.
+uint32_t input_manager_service(uint32_t now_ms);
+bool input_manager_get_event(InputEvent *out_event);
+// Debounced level.
+bool input_manager_is_pressed(InputButton button);
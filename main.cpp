@@ -5,6 +5,13 @@
 #include "power_manager.h"
 #include "audio_feedback_manager.h"
 #include "battery_manager.h"
+#include "boot_timeline.h"
+#include "energy_accounting.h"
+#include "input_manager.h"
+#include "ook_decoder.h"
+#include "rf_capture_manager.h"
+#include "scan_pacer.h"
+#include "trace_engine.h"
 
 #include "esp_log.h"
 #include "esp_sleep.h"
@@ -32,19 +39,40 @@ constexpr gpio_num_t POWER_BUTTON_GPIO = GPIO_NUM_16;
 constexpr gpio_num_t SYS_OUT_GPIO = GPIO_NUM_16;
 constexpr gpio_num_t BOOT_BUTTON_GPIO = GPIO_NUM_0;
 constexpr gpio_num_t USB_VBUS_GPIO = GPIO_NUM_4;
-constexpr int SCAN_DELAY_MS = 100;
+// Poll interval while no RF screen is shown.
+constexpr int RF_IDLE_POLL_MS = 100;
+// Detection passes run back to back with the radio busy 90% of the time; the rest is left to
+// loop() and the UI. Sweeps are paced by refresh rate: the coarse 32-point sweep with sub-bin
+// peak interpolation is short enough to reach 60 frames/s.
+constexpr ScanPacingConfig SCAN_PACING = {SCAN_PACING_DUTY, 90, 1000};
+constexpr ScanPacingConfig SPECTRUM_PACING = {SCAN_PACING_RATE, 60, 1000};
+// Screen locked: detection only, a couple of passes per second, no sweep or frame capture.
+constexpr ScanPacingConfig BACKGROUND_PACING = {SCAN_PACING_RATE, 2, 1000};
+constexpr bool BACKGROUND_AUDIO_ALERTS = true;
+// APB stays at 80 MHz from this frequency up, so SPI, I2S and RMT timings are unchanged.
+constexpr uint32_t LOCKED_CPU_MHZ = 80;
+constexpr uint32_t RF_STATS_LOG_MS = 10000;
+// Idle status refresh, by time now that the pass rate depends on pacing.
+constexpr uint32_t SCAN_STATUS_REFRESH_MS = 1000;
 constexpr float SWEEP_START_MHZ = 433.05f;
 constexpr float SWEEP_END_MHZ = 434.79f;
-constexpr uint16_t SWEEP_SAMPLE_COUNT = 96;
+constexpr uint16_t SWEEP_SAMPLE_COUNT = 32;
 constexpr uint32_t DETECT_BEEP_MIN_INTERVAL_MS = 900;
+// Fed to the sonifier while no RF screen is scanning: below every mapped level.
+constexpr int SONIFY_IDLE_RSSI_DBM = -128;
+// Time the radio stays parked on an OOK hit waiting for a complete frame on GDO0.
+constexpr uint32_t CAPTURE_WINDOW_MS = 250;
 constexpr uint32_t POWER_EVENTS_ARM_DELAY_MS = 3000;
 constexpr uint32_t POWER_EVENTS_ARM_DELAY_EXT_RESET_MS = 8000;
 constexpr uint32_t POWER_OFF_GUARD_EXT_RESET_BATTERY_MS = 30000;
-constexpr uint32_t STARTUP_SOUND_WAIT_MS = 3000;
-constexpr uint32_t LOOP_DELAY_MS = 10;
+// loop() sleeps on task notifications; this caps the sleep for housekeeping.
+constexpr uint32_t LOOP_MAX_SLEEP_MS = 1000;
+// Energy summary on serial; CPU shares are sampled on every loop wake (at most once per second).
+constexpr uint32_t ENERGY_LOG_MS = 60000;
+// Audio idle poll while a power cut is pending.
+constexpr uint32_t POWER_CUT_POLL_MS = 10;
 // Hold duration required to request power off.
 constexpr uint32_t POWER_HOLD_MS = 500;
-constexpr uint32_t BOOT_DEBOUNCE_MS = 500;
 // Earliest moment to cut power after requesting shutdown sound.
 constexpr uint32_t POWER_CUT_EARLIEST_MS = 100;
 // Hard deadline to cut power even if audio task did not report idle yet.
@@ -54,33 +82,69 @@ constexpr uint32_t POWER_IDLE_STABLE_MS = 1200;
 
 constexpr const char *NVS_NAMESPACE = "rf_cfg";
 constexpr const char *NVS_KEY_RSSI = "rssi_th";
+constexpr const char *NVS_KEY_RELATIVE = "th_rel";
+constexpr const char *NVS_KEY_NOISE_MARGIN = "noise_mg";
 
 int rssi_threshold = -60;
+// Relative mode: detect at noise_margin_db above each channel's learned floor.
+bool relative_threshold = false;
+int noise_margin_db = 10;
 bool screen_locked = false;
+// Read by rf_task: low-duty detect-only policy while the screen is locked.
+volatile bool rf_background = false;
+uint32_t unlocked_cpu_mhz = 0;
+// Sonification is paused while locked (two passes per second cannot drive it) and restored after.
+SonifyMode sonify_mode_before_lock = SONIFY_OFF;
 uint32_t ignore_power_events_until_ms = 0;
 bool power_events_armed = false;
 uint32_t power_off_allowed_after_ms = 0;
-bool power_btn_pressed = false;
-uint32_t power_btn_pressed_since_ms = 0;
 bool power_seen_released_since_arm = false;
 bool power_idle_stable = false;
 uint32_t power_idle_since_ms = 0;
 bool power_cut_pending = false;
 uint32_t power_cut_earliest_ms = 0;
 uint32_t power_cut_deadline_ms = 0;
-bool boot_btn_pressed = false;
+// setup() and loop() run in the Arduino loop task; input ISRs and UI producers wake it.
+TaskHandle_t loop_task_handle = nullptr;
+// Peak/avg/min traces over spectrum sweeps, RF task only.
+TraceEngine spectrum_traces;
+// Protocol decoders for captured OOK frames, RF task only.
+OokDecoderEngine ook_decoder;
+// Time budget of the scan loop, RF task only.
+ScanPacer scan_pacer;
 
 // BOOT button toggles only the backlight (TuneBar behavior).
+void set_backlight(uint8_t duty) {
+    setUpduty(duty);
+    energy_accounting_set_level(ENERGY_RAIL_BACKLIGHT, duty);
+}
+
 void set_screen_locked(bool locked) {
     if (locked == screen_locked) {
         return;
     }
     screen_locked = locked;
     if (screen_locked) {
-        setUpduty(LCD_PWM_MODE_0);
-        Serial.println("[SCREEN] LOCK");
+        set_backlight(LCD_PWM_MODE_0);
+        lvgl_port_run_with_gui([]() { ui_manager_set_suspended(true); });
+        rf_background = true;
+        sonify_mode_before_lock = audio_feedback_get_sonify_mode();
+        audio_feedback_set_sonify_mode(SONIFY_OFF);
+        // An idle open stream keeps I2S and the amplifier running; close it between sounds.
+        audio_feedback_set_persistent_stream(false);
+        unlocked_cpu_mhz = getCpuFrequencyMhz();
+        setCpuFrequencyMhz(LOCKED_CPU_MHZ);
+        Serial.printf("[SCREEN] LOCK (CPU %lu MHz)\n", static_cast<unsigned long>(getCpuFrequencyMhz()));
     } else {
-        setUpduty(LCD_PWM_MODE_200);
+        if (unlocked_cpu_mhz) {
+            setCpuFrequencyMhz(unlocked_cpu_mhz);
+        }
+        rf_background = false;
+        audio_feedback_set_persistent_stream(true);
+        audio_feedback_set_sonify_mode(sonify_mode_before_lock);
+        // Replay the latest state before the backlight comes back.
+        lvgl_port_run_with_gui([]() { ui_manager_set_suspended(false); });
+        set_backlight(LCD_PWM_MODE_200);
         Serial.println("[SCREEN] UNLOCK");
     }
 }
@@ -122,103 +186,381 @@ int load_threshold_from_nvs(int default_value) {
     return value;
 }
 
+// Persist relative-threshold settings only when they changed.
+void save_relative_threshold_to_nvs(bool enabled, int margin_db) {
+    static int last_enabled = -1;
+    static int last_margin = 9999;
+    if (static_cast<int>(enabled) == last_enabled && margin_db == last_margin) {
+        return;
+    }
+
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, false)) {
+        Serial.println("[NVS] Erreur ouverture (write)");
+        return;
+    }
+
+    prefs.putBool(NVS_KEY_RELATIVE, enabled);
+    prefs.putInt(NVS_KEY_NOISE_MARGIN, margin_db);
+    prefs.end();
+
+    last_enabled = enabled;
+    last_margin = margin_db;
+    Serial.printf("[NVS] Seuil relatif sauvegarde: %s, marge %d dB\n", enabled ? "ON" : "OFF", margin_db);
+}
+
+void load_relative_threshold_from_nvs() {
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, true)) {
+        Serial.println("[NVS] Erreur ouverture (read)");
+        return;
+    }
+
+    relative_threshold = prefs.getBool(NVS_KEY_RELATIVE, relative_threshold);
+    noise_margin_db = prefs.getInt(NVS_KEY_NOISE_MARGIN, noise_margin_db);
+    prefs.end();
+    Serial.printf("[NVS] Seuil relatif charge: %s, marge %d dB\n", relative_threshold ? "ON" : "OFF", noise_margin_db);
+}
+
 void on_threshold_changed(int value) {
     rssi_threshold = value;
 }
 
+void on_relative_threshold_changed(bool enabled, int margin_db) {
+    relative_threshold = enabled;
+    noise_margin_db = margin_db;
+    cc1101_manager_set_relative_threshold(enabled, margin_db);
+}
+
+const char *on_sonify_cycle() {
+    const SonifyMode next =
+        static_cast<SonifyMode>((audio_feedback_get_sonify_mode() + 1) % SONIFY_MODE_COUNT);
+    audio_feedback_set_sonify_mode(next);
+    return sonify_mode_name(next);
+}
+
 // Save callback triggered when user leaves threshold settings screen.
 void on_threshold_saved(int value) {
     rssi_threshold = value;
     save_threshold_to_nvs(value);
+    save_relative_threshold_to_nvs(relative_threshold, noise_margin_db);
 }
 
 void on_splash_done() {
     // Start RF scanning only after splash transition is finished.
+    boot_timeline_mark(BOOT_PHASE_SPLASH_DONE);
     app_state = STATE_SCANNING;
     ESP_LOGI("MAIN", "Splash termine -> SCANNING");
+    // Power events arm from SCANNING on.
+    if (loop_task_handle) {
+        xTaskNotifyGive(loop_task_handle);
+    }
 }
 
-void on_battery_update(uint8_t battery_state, float battery_voltage) {
-    ui_manager_queue_battery_update(battery_state, battery_voltage);
+void on_ui_update_queued() {
+    if (loop_task_handle) {
+        xTaskNotifyGive(loop_task_handle);
+    }
+}
+
+void on_battery_update(const BatteryEstimate &estimate) {
+    ui_manager_queue_battery_update(estimate.state, estimate.percent);
 }
 
 void process_ui_pending_locked() {
     ui_manager_process_pending_update();
 }
 
+// Radio is still in RX on the detected frequency: let the RMT timestamp one frame on GDO0,
+// then run the pulse train through the protocol decoders and report the first frame decoded.
+void capture_ook_frame(const Cc1101ScanResult &result, const char *mod) {
+    const uint32_t freq_hz = static_cast<uint32_t>(lroundf(result.detected_freq_mhz * 1e6f));
+    if (!rf_capture_manager_arm(freq_hz)) {
+        return;
+    }
+    PulseBlock *block = rf_capture_manager_take(CAPTURE_WINDOW_MS);
+    if (!block) {
+        rf_capture_manager_disarm();
+        return;
+    }
+
+    const PulseTrain pulses(*block);
+    ook_decoder.reset();
+    for (uint16_t i = 0; i < pulses.size(); ++i) {
+        ook_decoder.feed(pulses.level(i), pulses.duration_us(i));
+    }
+    ook_decoder.flush();
+    Serial.printf("[RMT] Trame capturee: %u impulsions @ %.3f MHz\n",
+                  static_cast<unsigned>(pulses.size()),
+                  block->frequency_hz / 1e6);
+    rf_capture_manager_release(block);
+
+    OokFrame frame;
+    if (!ook_decoder.pop_frame(&frame)) {
+        return;
+    }
+    char status_buf[64];
+    snprintf(status_buf,
+             sizeof(status_buf),
+             "%s %ub 0x%llX",
+             frame.protocol,
+             static_cast<unsigned>(frame.bit_count),
+             static_cast<unsigned long long>(frame.payload));
+    Serial.printf("[DECODE] %s | te %u us\n", status_buf, static_cast<unsigned>(frame.te_us));
+    ui_manager_queue_update(result.detected_freq_mhz, result.detected_rssi_dbm, mod, status_buf);
+}
+
 // Dedicated RF worker:
 // - spectrum screen => fast sweep around 433 MHz
 // - other screens  => normal detect scan
+// Block at least one tick so equal- and lower-priority tasks on this core get to run.
+void rf_idle(uint32_t idle_us) {
+    const TickType_t ticks = pdMS_TO_TICKS((idle_us + 999) / 1000);
+    vTaskDelay(ticks > 0 ? ticks : 1);
+}
+
 void rf_task(void *pv) {
     (void)pv;
     bool was_spectrum_mode = false;
+    bool was_background = false;
+    bool pacing_active = false;
     bool prev_signal_detected = false;
     uint32_t last_detect_beep_ms = 0;
+    uint32_t last_stats_log_ms = 0;
+    uint32_t last_status_ms = 0;
+    bool first_pass_done = false;
     while (true) {
-        if (app_state == STATE_SCANNING) {
-            if (!ui_manager_is_subghz_active()) {
-                if (was_spectrum_mode) {
-                    cc1101_manager_restore_scan_mode();
-                    was_spectrum_mode = false;
-                }
-                prev_signal_detected = false;
-                vTaskDelay(pdMS_TO_TICKS(SCAN_DELAY_MS));
-                continue;
+        if (app_state != STATE_SCANNING || !ui_manager_is_subghz_active()) {
+            if (was_spectrum_mode) {
+                cc1101_manager_restore_scan_mode();
+                was_spectrum_mode = false;
             }
+            prev_signal_detected = false;
+            pacing_active = false;
+            audio_feedback_sonify_rssi(SONIFY_IDLE_RSSI_DBM);
+            vTaskDelay(pdMS_TO_TICKS(RF_IDLE_POLL_MS));
+            continue;
+        }
 
-            const bool spectrum_mode = ui_manager_is_spectrum_active();
+        const bool background = rf_background;
+        // Nothing is drawn while locked: the spectrum screen falls back to detection.
+        const bool spectrum_mode = !background && ui_manager_is_spectrum_active();
+        // A new loop or mode starts a fresh time budget and stats window.
+        if (!pacing_active || spectrum_mode != was_spectrum_mode || background != was_background) {
+            const ScanPacingConfig &pacing = background ? BACKGROUND_PACING
+                                           : spectrum_mode ? SPECTRUM_PACING
+                                                           : SCAN_PACING;
+            scan_pacer.configure(pacing);
+            pacing_active = true;
+            was_background = background;
+        }
+        scan_pacer.begin_pass(micros());
 
-            // Leaving spectrum can leave radio in a temporary profile, request scan restore.
-            if (was_spectrum_mode && !spectrum_mode) {
-                cc1101_manager_restore_scan_mode();
+        // Leaving spectrum can leave radio in a temporary profile, request scan restore.
+        if (was_spectrum_mode && !spectrum_mode) {
+            cc1101_manager_restore_scan_mode();
+        }
+        // Each visit to the spectrum screen starts fresh peak/avg/min traces.
+        if (!was_spectrum_mode && spectrum_mode) {
+            spectrum_traces.reset();
+        }
+        was_spectrum_mode = spectrum_mode;
+
+        if (spectrum_mode) {
+            prev_signal_detected = false;
+            // Sweep feed for spectrum bars, captured straight into a free UI frame.
+            SpectrumFrame *frame = ui_manager_acquire_spectrum_frame();
+            if (cc1101_manager_capture_sweep(SWEEP_START_MHZ,
+                                             SWEEP_END_MHZ,
+                                             SWEEP_SAMPLE_COUNT,
+                                             &frame->sweep)) {
+                spectrum_traces.push(frame->sweep.rssi_dbm, frame->sweep.sample_count);
+                spectrum_traces.export_dbm(frame->peak_dbm, frame->avg_dbm, frame->min_dbm);
+                frame->traces_valid = (spectrum_traces.bin_count() == frame->sweep.sample_count);
+                audio_feedback_sonify_rssi(frame->sweep.max_rssi_dbm);
+                ui_manager_publish_spectrum_frame();
             }
-            was_spectrum_mode = spectrum_mode;
+        } else {
+            // Main detection flow used by freq-only and main screens.
+            const Cc1101ScanResult result = cc1101_manager_scan_once(rssi_threshold);
+            // Every pass feeds the sonifier, hit or not, so the sound follows the band continuously.
+            audio_feedback_sonify_rssi(result.signal_detected ? result.detected_rssi_dbm : result.best_rssi_dbm);
+
+            if (result.signal_detected) {
+                char mod[16];
+                snprintf(mod,
+                         sizeof(mod),
+                         "%s %u%%",
+                         modulation_class_name(result.modulation),
+                         static_cast<unsigned>(result.modulation_confidence_pct));
+                ui_manager_set_last_signal(result.detected_freq_mhz, result.detected_rssi_dbm, mod);
+                ui_manager_queue_update(result.detected_freq_mhz,
+                                        result.detected_rssi_dbm,
+                                        mod,
+                                        "Signal detecte");
+                // Sonification already voices the hit, and needs a fresh RSSI every pass: the
+                // frame capture would hold the pass for up to CAPTURE_WINDOW_MS, so skip it.
+                const bool sonifying = audio_feedback_get_sonify_mode() != SONIFY_OFF;
+                if (!result.is_fsk && !background && !sonifying) {
+                    capture_ook_frame(result, mod);
+                }
 
-            if (spectrum_mode) {
-                prev_signal_detected = false;
-                Cc1101SweepResult sweep{};
-                // Sweep feed for spectrum bars.
-                if (cc1101_manager_capture_sweep(SWEEP_START_MHZ,
-                                                 SWEEP_END_MHZ,
-                                                 SWEEP_SAMPLE_COUNT,
-                                                 &sweep)) {
-                    ui_manager_queue_spectrum_update(sweep);
+                const uint32_t now_ms = millis();
+                const bool beep_screen = background ? BACKGROUND_AUDIO_ALERTS : ui_manager_is_freq_only_active();
+                if (beep_screen && !sonifying &&
+                    (!prev_signal_detected || (now_ms - last_detect_beep_ms) >= DETECT_BEEP_MIN_INTERVAL_MS)) {
+                    audio_feedback_play_detect();
+                    last_detect_beep_ms = now_ms;
                 }
+                prev_signal_detected = true;
+            } else if (!background && millis() - last_status_ms >= SCAN_STATUS_REFRESH_MS) {
+                last_status_ms = millis();
+                // Keep UI alive with periodic status while no signal is found.
+                char status_buf[64];
+                snprintf(status_buf,
+                         sizeof(status_buf),
+                         "Scan #%d - %.0f/s - En attente...",
+                         result.scan_count,
+                         scan_pacer.passes_per_second());
+                ui_manager_queue_update(0.0f, result.best_rssi_dbm, "---", status_buf);
+                prev_signal_detected = false;
             } else {
-                // Main detection flow used by freq-only and main screens.
-                const Cc1101ScanResult result = cc1101_manager_scan_once(rssi_threshold);
-
-                if (result.signal_detected) {
-                    const char *mod = result.is_fsk ? "FSK" : "ASK/OOK";
-                    ui_manager_set_last_signal(result.detected_freq_mhz, result.detected_rssi_dbm, mod);
-                    ui_manager_queue_update(result.detected_freq_mhz,
-                                            result.detected_rssi_dbm,
-                                            mod,
-                                            "Signal detecte");
-
-                    const uint32_t now_ms = millis();
-                    if (ui_manager_is_freq_only_active() &&
-                        (!prev_signal_detected || (now_ms - last_detect_beep_ms) >= DETECT_BEEP_MIN_INTERVAL_MS)) {
-                        audio_feedback_play_detect();
-                        last_detect_beep_ms = now_ms;
-                    }
-                    prev_signal_detected = true;
-                } else if ((result.scan_count % 10) == 0) {
-                    // Keep UI alive with periodic status while no signal is found.
-                    char status_buf[64];
-                    snprintf(status_buf, sizeof(status_buf), "Scan #%d - En attente...", result.scan_count);
-                    ui_manager_queue_update(0.0f, result.best_rssi_dbm, "---", status_buf);
-                    prev_signal_detected = false;
-                } else {
-                    prev_signal_detected = false;
-                }
+                prev_signal_detected = false;
             }
         }
 
-        vTaskDelay(pdMS_TO_TICKS(SCAN_DELAY_MS));
+        const uint32_t idle_us = scan_pacer.end_pass(micros());
+        if (!first_pass_done) {
+            first_pass_done = true;
+            boot_timeline_mark(BOOT_PHASE_FIRST_SCAN);
+            boot_timeline_print_once();
+        }
+        const uint32_t now_ms = millis();
+        if (now_ms - last_stats_log_ms >= RF_STATS_LOG_MS) {
+            last_stats_log_ms = now_ms;
+            Serial.printf("[RF] %s: %.1f passes/s, radio occupee %u.%u%%, passe %lu us\n",
+                          was_background ? "veille" : (was_spectrum_mode ? "spectre" : "scan"),
+                          scan_pacer.passes_per_second(),
+                          scan_pacer.busy_permille() / 10,
+                          scan_pacer.busy_permille() % 10,
+                          static_cast<unsigned long>(scan_pacer.last_pass_us()));
+        }
+        rf_idle(idle_us);
     }
 }
 
+// Radio bring-up runs on core 0 while setup() builds the UI on core 1;
+// the scan task only exists once the radio is ready.
+void rf_boot_task(void *pv) {
+    (void)pv;
+    if (!cc1101_manager_init(rssi_threshold)) {
+        Serial.println("\nERREUR FATALE: Impossible d'initialiser le CC1101");
+        ui_manager_queue_update(0.0f, -128, "---", "ERREUR: CC1101 absent");
+        // No scan task: this one-shot task ends here and frees its stack.
+        vTaskDelete(nullptr);
+        return;
+    }
+    // Frame capture is optional: detection keeps working without it.
+    rf_capture_manager_init(cc1101_manager_gdo0_gpio());
+    if (!trace_engine_self_test()) {
+        Serial.println("[TRACE] ERREUR: noyaux PIE differents du scalaire, repli scalaire");
+    }
+    cc1101_manager_set_relative_threshold(relative_threshold, noise_margin_db);
+    boot_timeline_mark(BOOT_PHASE_RADIO);
+
+    xTaskCreatePinnedToCore(
+        rf_task,
+        "rf_task",
+        12288,
+        nullptr,
+        3,
+        nullptr,
+        1
+    );
+    vTaskDelete(nullptr);
+}
+
+// TuneBar power behavior: long-press SYS_OUT then cut latch directly.
+// The press only counts once the button was seen released for POWER_IDLE_STABLE_MS after arming.
+void request_power_off(uint32_t now_ms) {
+    if (usb_connected()) {
+        Serial.println("[POWER] USB present");
+    } else if (power_off_allowed_after_ms && (now_ms < power_off_allowed_after_ms)) {
+        Serial.println("[POWER] OFF blocked by reset guard");
+    } else {
+        // Shutdown is two-step: request off, then wait a short window for audio.
+        Serial.println("[POWER] OFF");
+        power_manager_off_request();
+        audio_feedback_play_shutdown();
+        power_cut_pending = true;
+        power_cut_earliest_ms = now_ms + POWER_CUT_EARLIEST_MS;
+        power_cut_deadline_ms = now_ms + POWER_CUT_DEADLINE_MS;
+    }
+}
+
+void handle_power_event(const InputEvent &event) {
+    switch (event.type) {
+    case INPUT_EVENT_RELEASE:
+        power_seen_released_since_arm = true;
+        power_idle_since_ms = event.timestamp_ms;
+        break;
+    case INPUT_EVENT_PRESS:
+        if (power_seen_released_since_arm && (event.timestamp_ms - power_idle_since_ms) >= POWER_IDLE_STABLE_MS) {
+            power_idle_stable = true;
+        }
+        break;
+    case INPUT_EVENT_LONG_PRESS:
+        if (power_idle_stable && !power_cut_pending) {
+            request_power_off(event.timestamp_ms);
+        }
+        break;
+    }
+}
+
+void handle_input_event(const InputEvent &event) {
+    // Buttons are ignored until startup is fully stable.
+    if (!power_events_armed) {
+        return;
+    }
+    if (event.button == INPUT_BUTTON_POWER) {
+        handle_power_event(event);
+    } else if (event.button == INPUT_BUTTON_BOOT && event.type == INPUT_EVENT_PRESS) {
+        // TuneBar BOOT behavior: toggle backlight/screen lock.
+        set_screen_locked(!screen_locked);
+    }
+}
+
+// Arming and the pending power cut; returns the ms until this needs to run again.
+uint32_t service_power(uint32_t now_ms) {
+    // Arm power button events only after startup is fully stable.
+    if (!power_events_armed) {
+        if (app_state != STATE_SCANNING) {
+            return UINT32_MAX;
+        }
+        if (now_ms < ignore_power_events_until_ms) {
+            return ignore_power_events_until_ms - now_ms;
+        }
+        power_events_armed = true;
+        power_seen_released_since_arm = !input_manager_is_pressed(INPUT_BUTTON_POWER);
+        power_idle_stable = false;
+        power_idle_since_ms = now_ms;
+        Serial.println("[POWER] Events armed");
+    }
+
+    if (!power_cut_pending) {
+        return UINT32_MAX;
+    }
+    const bool cut_time_reached = (now_ms >= power_cut_deadline_ms);
+    const bool audio_done = audio_feedback_is_idle() && (now_ms >= power_cut_earliest_ms);
+    if (cut_time_reached || audio_done) {
+        power_manager_commit_power_off();
+        while (true) {
+            vTaskDelay(pdMS_TO_TICKS(POWER_CUT_POLL_MS));
+        }
+    }
+    return POWER_CUT_POLL_MS;
+}
+
 void print_banner() {
     Serial.println("\n\n");
     Serial.println("╔═══════════════════════════════════════════════════╗");
@@ -242,6 +584,8 @@ void enter_deep_sleep_now() {
 }  // namespace
 
 void setup() {
+    boot_timeline_mark(BOOT_PHASE_SETUP);
+    energy_accounting_init();
     // Hold power latch as early as possible to survive battery-only reset transitions.
     Serial.begin(115200);
     delay(50);
@@ -249,8 +593,10 @@ void setup() {
     power_manager_init();
     power_manager_on();
     pinMode(USB_VBUS_GPIO, INPUT);
-    pinMode(SYS_OUT_GPIO, INPUT_PULLUP);
-    pinMode(BOOT_BUTTON_GPIO, INPUT_PULLUP);
+    loop_task_handle = xTaskGetCurrentTaskHandle();
+    input_manager_init(loop_task_handle);
+    input_manager_add_button(INPUT_BUTTON_POWER, SYS_OUT_GPIO, POWER_HOLD_MS);
+    input_manager_add_button(INPUT_BUTTON_BOOT, BOOT_BUTTON_GPIO, 0);
     // Ignore early false long-press events right after boot.
     const esp_reset_reason_t rr = esp_reset_reason();
     const bool ext_reset = (rr == ESP_RST_EXT);
@@ -266,49 +612,47 @@ void setup() {
     }
 
     lcd_bl_pwm_bsp_init(LCD_PWM_MODE_255);
-    setUpduty(LCD_PWM_MODE_200);
+    set_backlight(LCD_PWM_MODE_200);
     screen_locked = false;
 
     print_banner();
 
     rssi_threshold = load_threshold_from_nvs(-60);
+    load_relative_threshold_from_nvs();
+    boot_timeline_mark(BOOT_PHASE_CONFIG);
 
-    // Radio must be ready before UI starts consuming scan data.
-    if (!cc1101_manager_init(rssi_threshold)) {
-        Serial.println("\nERREUR FATALE: Impossible d'initialiser le CC1101");
-        while (1) {
-            delay(1000);
-        }
-    }
-
+    // Radio and codec come up on core 0 while the UI is built here on core 1.
+    // rf_task is started by the radio boot task and waits for the splash before scanning.
+    xTaskCreatePinnedToCore(
+        rf_boot_task,
+        "rf_boot_task",
+        8192,
+        nullptr,
+        2,
+        nullptr,
+        0
+    );
+    // The startup sound plays in the background; it no longer holds the display.
     audio_feedback_init();
     audio_feedback_play_startup();
-    uint32_t audio_wait_start = millis();
-    while (!audio_feedback_is_idle() && (millis() - audio_wait_start < STARTUP_SOUND_WAIT_MS)) {
-        vTaskDelay(pdMS_TO_TICKS(LOOP_DELAY_MS));
-    }
-
-    Serial.println("\nSysteme pret");
-    Serial.println("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n");
-    Serial.println("Debut du scan...\n");
+    battery_manager_init(on_battery_update);
+    boot_timeline_mark(BOOT_PHASE_BATTERY);
 
+    ui_manager_set_update_queued_cb(on_ui_update_queued);
     lvgl_port_init();
     // Create UI while holding LVGL internal mutex.
     lvgl_port_run_with_gui([]() {
+        ui_manager_set_relative_threshold(relative_threshold, noise_margin_db, on_relative_threshold_changed);
+        ui_manager_set_diag_text_cb(energy_accounting_format);
+        ui_manager_set_spectrum_sweep(SWEEP_SAMPLE_COUNT, SPECTRUM_PACING.value);
+        ui_manager_set_sonify_cb(sonify_mode_name(audio_feedback_get_sonify_mode()), on_sonify_cycle);
         ui_manager_init(rssi_threshold, on_threshold_changed, on_threshold_saved);
         ui_manager_create_splash(on_splash_done);
     });
-    battery_manager_init(on_battery_update);
+    boot_timeline_mark(BOOT_PHASE_UI);
 
-    xTaskCreatePinnedToCore(
-        rf_task,
-        "rf_task",
-        12288,
-        nullptr,
-        3,
-        nullptr,
-        1
-    );
+    Serial.println("\nSysteme pret");
+    Serial.println("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n");
     app_state = STATE_SPLASH;
 }
 
@@ -316,78 +660,27 @@ void loop() {
     // Apply queued UI updates from RF task under LVGL mutex.
     lvgl_port_run_with_gui(process_ui_pending_locked);
 
-    // Arm power button events only after startup is fully stable.
-    if (!power_events_armed &&
-        app_state == STATE_SCANNING &&
-        millis() >= ignore_power_events_until_ms) {
-        power_events_armed = true;
-        power_seen_released_since_arm = false;
-        power_idle_stable = false;
-        power_idle_since_ms = millis();
-        Serial.println("[POWER] Events armed");
+    const uint32_t now_ms = millis();
+    uint32_t wait_ms = input_manager_service(now_ms);
+    InputEvent event;
+    while (input_manager_get_event(&event)) {
+        handle_input_event(event);
+    }
+    energy_accounting_sample_cpu();
+    static uint32_t last_energy_log_ms = 0;
+    if (now_ms - last_energy_log_ms >= ENERGY_LOG_MS) {
+        last_energy_log_ms = now_ms;
+        energy_accounting_print();
     }
 
-    // TuneBar power behavior: long-press SYS_OUT then cut latch directly.
-    if (power_events_armed) {
-        const bool pressed_now = (digitalRead(SYS_OUT_GPIO) == LOW);
-        const uint32_t now_ms = millis();
-
-        if (!pressed_now) {
-            power_seen_released_since_arm = true;
-            if (!power_idle_stable) {
-                if ((now_ms - power_idle_since_ms) >= POWER_IDLE_STABLE_MS) {
-                    power_idle_stable = true;
-                }
-            }
-        } else {
-            power_idle_since_ms = now_ms;
-        }
-
-        if (pressed_now && power_seen_released_since_arm && power_idle_stable && !power_cut_pending) {
-            if (!power_btn_pressed) {
-                power_btn_pressed = true;
-                power_btn_pressed_since_ms = now_ms;
-            } else if (now_ms - power_btn_pressed_since_ms >= POWER_HOLD_MS) {
-                if (usb_connected()) {
-                    Serial.println("[POWER] USB present");
-                } else if (power_off_allowed_after_ms && (now_ms < power_off_allowed_after_ms)) {
-                    Serial.println("[POWER] OFF blocked by reset guard");
-                } else {
-                    // Shutdown is two-step: request off, then wait a short window for audio.
-                    Serial.println("[POWER] OFF");
-                    power_manager_off_request();
-                    audio_feedback_play_shutdown();
-                    power_cut_pending = true;
-                    power_cut_earliest_ms = now_ms + POWER_CUT_EARLIEST_MS;
-                    power_cut_deadline_ms = now_ms + POWER_CUT_DEADLINE_MS;
-                }
-                power_btn_pressed_since_ms = now_ms;
-            }
-        } else if (power_btn_pressed) {
-            power_btn_pressed = false;
-        }
-
-        if (power_cut_pending) {
-            const bool cut_time_reached = (now_ms >= power_cut_deadline_ms);
-            const bool audio_done = audio_feedback_is_idle() && (now_ms >= power_cut_earliest_ms);
-            if (cut_time_reached || audio_done) {
-                power_manager_commit_power_off();
-                while (true) {
-                    vTaskDelay(pdMS_TO_TICKS(LOOP_DELAY_MS));
-                }
-            }
-        }
-
-        // TuneBar BOOT behavior: toggle backlight/screen lock with debounce.
-        const bool boot_pressed_now = (digitalRead(BOOT_BUTTON_GPIO) == LOW);
-        if (boot_pressed_now && !boot_btn_pressed) {
-            boot_btn_pressed = true;
-            vTaskDelay(pdMS_TO_TICKS(BOOT_DEBOUNCE_MS));
-            set_screen_locked(!screen_locked);
-        } else if (!boot_pressed_now && boot_btn_pressed) {
-            boot_btn_pressed = false;
-        }
+    const uint32_t power_wait_ms = service_power(now_ms);
+    if (power_wait_ms < wait_ms) {
+        wait_ms = power_wait_ms;
+    }
+    if (wait_ms > LOOP_MAX_SLEEP_MS) {
+        wait_ms = LOOP_MAX_SLEEP_MS;
     }
 
-    vTaskDelay(pdMS_TO_TICKS(LOOP_DELAY_MS));
+    // Sleep until an input edge, a UI producer or the next input/power deadline.
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait_ms));
 }
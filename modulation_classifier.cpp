@@ -0,0 +1,141 @@
+#include "modulation_classifier.h"
+
+#include <math.h>
+
+namespace {
+
+// Envelope span ramps the OOK evidence from 4 dB (receiver noise) to 12 dB (clear keying).
+constexpr float kSpanNoiseDb = 4.0f;
+constexpr float kSpanKeyedDb = 12.0f;
+// Separation of a single level split at its mean: 1 - 2/pi for Gaussian noise,
+// 0.75 for the flat, quantised noise of the RSSI register.
+constexpr float kUnimodalSeparation = 0.75f;
+constexpr float kBimodalSeparation = 0.92f;
+// Transitions need to move past the mid level by a quarter of the span, at least 2 dB.
+constexpr int16_t kMinHysteresisDb = 2;
+constexpr uint16_t kMinKeyedTransitions = 2;
+
+float ramp(float value, float low, float high) {
+    if (value <= low) {
+        return 0.0f;
+    }
+    if (value >= high) {
+        return 1.0f;
+    }
+    return (value - low) / (high - low);
+}
+
+}  // namespace
+
+ModulationFeatures modulation_extract_features(const int16_t *rssi_dbm, uint16_t count) {
+    ModulationFeatures features = {};
+    if (!rssi_dbm || count == 0) {
+        return features;
+    }
+
+    features.min_dbm = rssi_dbm[0];
+    features.max_dbm = rssi_dbm[0];
+    int32_t sum = 0;
+    for (uint16_t i = 0; i < count; ++i) {
+        const int16_t v = rssi_dbm[i];
+        if (v < features.min_dbm) {
+            features.min_dbm = v;
+        }
+        if (v > features.max_dbm) {
+            features.max_dbm = v;
+        }
+        sum += v;
+    }
+    features.mean_dbm = static_cast<float>(sum) / count;
+
+    const int16_t mid = static_cast<int16_t>((features.min_dbm + features.max_dbm) / 2);
+    int16_t hysteresis = static_cast<int16_t>((features.max_dbm - features.min_dbm) / 4);
+    if (hysteresis < kMinHysteresisDb) {
+        hysteresis = kMinHysteresisDb;
+    }
+    float total_var = 0.0f;
+    int32_t on_sum = 0;
+    int32_t off_sum = 0;
+    uint16_t on_count = 0;
+    bool high = rssi_dbm[0] > mid;
+    for (uint16_t i = 0; i < count; ++i) {
+        const int16_t v = rssi_dbm[i];
+        const float d = v - features.mean_dbm;
+        total_var += d * d;
+        if (v > mid) {
+            on_sum += v;
+            on_count++;
+        } else {
+            off_sum += v;
+        }
+
+        if (!high && v >= mid + hysteresis) {
+            high = true;
+            features.transitions++;
+        } else if (high && v <= mid - hysteresis) {
+            high = false;
+            features.transitions++;
+        }
+    }
+    total_var /= count;
+    features.stddev_db = sqrtf(total_var);
+    features.on_ratio = static_cast<float>(on_count) / count;
+
+    // Within-cluster variance around the on/off means.
+    const uint16_t off_count = count - on_count;
+    const float on_mean = on_count ? static_cast<float>(on_sum) / on_count : 0.0f;
+    const float off_mean = off_count ? static_cast<float>(off_sum) / off_count : 0.0f;
+    float within_var = 0.0f;
+    for (uint16_t i = 0; i < count; ++i) {
+        const float d = rssi_dbm[i] - ((rssi_dbm[i] > mid) ? on_mean : off_mean);
+        within_var += d * d;
+    }
+    within_var /= count;
+    features.bimodality = (total_var > 0.0f) ? 1.0f - within_var / total_var : 0.0f;
+    return features;
+}
+
+ModulationDecision modulation_classify(const int16_t *rssi_dbm, uint16_t count, int16_t floor_dbm) {
+    ModulationDecision decision = {};
+    decision.modulation = MODULATION_UNKNOWN;
+    if (!rssi_dbm || count < MODULATION_MIN_SAMPLES) {
+        return decision;
+    }
+
+    decision.features = modulation_extract_features(rssi_dbm, count);
+    const ModulationFeatures &f = decision.features;
+
+    const float span = static_cast<float>(f.max_dbm - f.min_dbm);
+    float ook = 0.5f * ramp(span, kSpanNoiseDb, kSpanKeyedDb) +
+                0.5f * ramp(f.bimodality, kUnimodalSeparation, kBimodalSeparation);
+    // A single edge is a burst starting or ending inside the dwell, not keying.
+    if (f.transitions < kMinKeyedTransitions) {
+        ook *= 0.4f;
+    }
+
+    if (ook >= 0.5f) {
+        if (f.max_dbm - floor_dbm < MODULATION_MIN_CARRIER_DB) {
+            return decision;
+        }
+        decision.modulation = MODULATION_ASK_OOK;
+        decision.confidence_pct = static_cast<uint8_t>(lroundf(ook * 100.0f));
+    } else {
+        if (f.mean_dbm - floor_dbm < MODULATION_MIN_CARRIER_DB) {
+            return decision;
+        }
+        decision.modulation = MODULATION_FSK;
+        decision.confidence_pct = static_cast<uint8_t>(lroundf((1.0f - ook) * 100.0f));
+    }
+    return decision;
+}
+
+const char *modulation_class_name(ModulationClass modulation) {
+    switch (modulation) {
+        case MODULATION_ASK_OOK:
+            return "ASK/OOK";
+        case MODULATION_FSK:
+            return "FSK";
+        default:
+            return "?";
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdint.h>
+
+enum ModulationClass : uint8_t {
+    MODULATION_UNKNOWN = 0,
+    MODULATION_ASK_OOK,
+    MODULATION_FSK,
+};
+
+// Envelope statistics of one RSSI burst.
+struct ModulationFeatures {
+    int16_t min_dbm;
+    int16_t max_dbm;
+    float mean_dbm;
+    float stddev_db;
+    // Share of samples above the mid level between min and max.
+    float on_ratio;
+    // Otsu-style separation: 1 - within-cluster / total variance around the mid level.
+    // Two well split levels give ~1, a single noisy level 0.64..0.75.
+    float bimodality;
+    // Crossings of the mid level, with hysteresis.
+    uint16_t transitions;
+};
+
+struct ModulationDecision {
+    ModulationClass modulation;
+    // 0..100.
+    uint8_t confidence_pct;
+    ModulationFeatures features;
+};
+
+constexpr uint16_t MODULATION_MIN_SAMPLES = 8;
+// The carrier must clear the noise floor by this much before it is classified: a noise-only
+// dwell has a flat envelope and would otherwise read as constant-envelope FSK.
+constexpr int16_t MODULATION_MIN_CARRIER_DB = 6;
+
+// OOK keys the carrier on and off: wide, bimodal envelope with repeated transitions.
+// FSK keeps a constant envelope: a narrow, unimodal RSSI distribution.
+// UNKNOWN with 0% when the on level (OOK) or the whole envelope (FSK) is within
+// MODULATION_MIN_CARRIER_DB of floor_dbm.
+ModulationFeatures modulation_extract_features(const int16_t *rssi_dbm, uint16_t count);
+ModulationDecision modulation_classify(const int16_t *rssi_dbm, uint16_t count, int16_t floor_dbm);
+const char *modulation_class_name(ModulationClass modulation);
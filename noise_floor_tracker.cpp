@@ -0,0 +1,79 @@
+#include "noise_floor_tracker.h"
+
+namespace {
+
+constexpr int kQ4Shift = 4;
+// Full step per accepted sample, Q4, split between the up and down moves by the percentile: at
+// the default median that is 0.5 dB per direction while warming up, then 0.125 dB.
+constexpr int32_t kWarmupStepQ4 = 16;
+constexpr int32_t kSteadyStepQ4 = 4;
+
+}  // namespace
+
+bool NoiseFloorTracker::init(NoiseFloorCell *cells, uint16_t channel_count, uint8_t percentile) {
+    if (!cells || channel_count == 0 || percentile == 0 || percentile >= 100) {
+        return false;
+    }
+    cells_ = cells;
+    channel_count_ = channel_count;
+    percentile_ = percentile;
+    reset();
+    return true;
+}
+
+void NoiseFloorTracker::reset() {
+    for (uint16_t i = 0; i < channel_count_; ++i) {
+        cells_[i].floor_q4 = 0;
+        cells_[i].samples = 0;
+        cells_[i].updated_ms = 0;
+    }
+}
+
+void NoiseFloorTracker::update(uint16_t channel, int rssi_dbm, uint32_t now_ms) {
+    if (channel >= channel_count_) {
+        return;
+    }
+    NoiseFloorCell &cell = cells_[channel];
+    const int32_t sample_q4 = static_cast<int32_t>(rssi_dbm) * (1 << kQ4Shift);
+
+    if (cell.samples == 0) {
+        cell.floor_q4 = static_cast<int16_t>(sample_q4);
+        cell.samples = 1;
+        cell.updated_ms = now_ms;
+        return;
+    }
+    if (now_ms - cell.updated_ms < kUpdateIntervalMs) {
+        return;
+    }
+    cell.updated_ms = now_ms;
+
+    const int32_t step = (cell.samples < kWarmupSamples) ? kWarmupStepQ4 : kSteadyStepQ4;
+    int32_t floor_q4 = cell.floor_q4;
+    // Up and down steps weighted by the percentile; rounded so neither side becomes zero.
+    if (sample_q4 > floor_q4) {
+        floor_q4 += (step * percentile_ + 50) / 100;
+        if (floor_q4 > sample_q4) {
+            floor_q4 = sample_q4;
+        }
+    } else if (sample_q4 < floor_q4) {
+        floor_q4 -= (step * (100 - percentile_) + 50) / 100;
+        if (floor_q4 < sample_q4) {
+            floor_q4 = sample_q4;
+        }
+    }
+    cell.floor_q4 = static_cast<int16_t>(floor_q4);
+    if (cell.samples < kWarmupSamples) {
+        cell.samples++;
+    }
+}
+
+bool NoiseFloorTracker::is_ready(uint16_t channel) const {
+    return channel < channel_count_ && cells_[channel].samples >= kWarmupSamples;
+}
+
+int NoiseFloorTracker::floor_dbm(uint16_t channel) const {
+    if (channel >= channel_count_) {
+        return 0;
+    }
+    return cells_[channel].floor_q4 >> kQ4Shift;
+}
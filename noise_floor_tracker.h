@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdint.h>
+
+// Streaming percentile estimate of one channel's RSSI, in Q4 dBm (1/16 dB).
+// The estimate, a warm-up counter and the time it last moved: no sample window is stored.
+struct NoiseFloorCell {
+    int16_t floor_q4;
+    uint8_t samples;
+    uint32_t updated_ms;
+};
+
+// Frugal quantile tracker: each sample nudges the estimate up by q * step when above it,
+// down by (1 - q) * step when below, so it settles where a fraction q of samples lie below.
+// Bursts shorter than (1 - q) of the time do not lift the floor.
+// A channel takes at most one sample per kUpdateIntervalMs, so the adaptation rate is set in
+// time and does not follow how often the scan loop happens to visit the channel.
+class NoiseFloorTracker {
+public:
+    // Median by default.
+    static constexpr uint8_t kDefaultPercentile = 50;
+    // Samples before a channel's floor is trusted.
+    static constexpr uint8_t kWarmupSamples = 16;
+    // 4 samples/s: a 4 s warm-up, then at most 0.5 dB/s of drift at the median.
+    static constexpr uint32_t kUpdateIntervalMs = 250;
+
+    bool init(NoiseFloorCell *cells, uint16_t channel_count, uint8_t percentile = kDefaultPercentile);
+    void reset();
+
+    // Samples arriving within kUpdateIntervalMs of the channel's last accepted one are ignored.
+    void update(uint16_t channel, int rssi_dbm, uint32_t now_ms);
+    bool is_ready(uint16_t channel) const;
+    int floor_dbm(uint16_t channel) const;
+
+private:
+    NoiseFloorCell *cells_ = nullptr;
+    uint16_t channel_count_ = 0;
+    uint8_t percentile_ = kDefaultPercentile;
+};
@@ -0,0 +1,304 @@
+#include "ook_decoder.h"
+
+namespace {
+
+enum Phase : uint8_t {
+    PHASE_WAIT_GAP = 0,
+    PHASE_START,
+    PHASE_FIRST,
+    PHASE_SECOND,
+};
+
+// Remote timings drift with battery and temperature: +-35% around the expected duration.
+constexpr uint32_t kTolerancePct = 35;
+// PWM_RATIO: the long half must be at least 1.5x the short one.
+constexpr uint32_t kMinRatioNum = 3;
+constexpr uint32_t kMinRatioDen = 2;
+
+// Timings from common public descriptions of each remote family.
+constexpr OokProtocolSpec kProtocols[] = {
+    // PT2262 / EV1527: 0 = 1H 3L, 1 = 3H 1L, frame ends with a 1H 31L sync; te varies per remote.
+    {"Princeton", OOK_CODING_PWM, OOK_PAIR_HIGH_LOW, 0, 150, 700, 1, 3, 3, 1, 0, 31, 0, true, 24, 24, false},
+    // CAME 12/24 bit: long header gap, start high, then low/high pairs 0 = 1L 2H, 1 = 2L 1H.
+    {"CAME", OOK_CODING_PWM, OOK_PAIR_LOW_HIGH, 320, 0, 0, 1, 2, 2, 1, 1, 20, 0, false, 12, 24, false},
+    // Nice FLO 12/24 bit: same framing as CAME with te = 700 us.
+    {"Nice FLO", OOK_CODING_PWM, OOK_PAIR_LOW_HIGH, 700, 0, 0, 1, 2, 2, 1, 1, 20, 0, false, 12, 24, false},
+    {"PWM", OOK_CODING_PWM_RATIO, OOK_PAIR_HIGH_LOW, 0, 100, 5000, 0, 0, 0, 0, 0, 0, 3000, false, 8, 64, true},
+    {"Manchester", OOK_CODING_MANCHESTER, OOK_PAIR_HIGH_LOW, 0, 150, 2000, 0, 0, 0, 0, 0, 0, 3000, false, 8, 64, true},
+};
+constexpr uint8_t kProtocolCount = sizeof(kProtocols) / sizeof(kProtocols[0]);
+static_assert(kProtocolCount <= OokDecoderEngine::kMaxProtocols, "protocol table too large");
+
+bool matches(uint32_t duration_us, uint32_t expected_us) {
+    const uint32_t diff = (duration_us > expected_us) ? duration_us - expected_us : expected_us - duration_us;
+    return diff * 100 <= expected_us * kTolerancePct;
+}
+
+}  // namespace
+
+const OokProtocolSpec *ook_protocol_table(uint8_t *out_count) {
+    if (out_count) {
+        *out_count = kProtocolCount;
+    }
+    return kProtocols;
+}
+
+OokDecoderEngine::OokDecoderEngine() : OokDecoderEngine(kProtocols, kProtocolCount) {
+}
+
+OokDecoderEngine::OokDecoderEngine(const OokProtocolSpec *table, uint8_t count)
+    : table_(table), count_((count > kMaxProtocols) ? kMaxProtocols : count) {
+    reset();
+}
+
+void OokDecoderEngine::reset() {
+    for (uint8_t i = 0; i < kMaxProtocols; ++i) {
+        states_[i] = State{};
+    }
+    frame_head_ = 0;
+    frame_count_ = 0;
+}
+
+bool OokDecoderEngine::is_gap(const OokProtocolSpec &spec, const State &state, bool level, uint32_t duration_us) const {
+    if (level) {
+        return false;
+    }
+    // Inside a frame the learnt te gives the tightest bound.
+    const uint16_t te = state.te_us ? state.te_us : spec.te_us;
+    if (spec.gap_te && te && state.phase != PHASE_WAIT_GAP) {
+        return duration_us * 100 >= static_cast<uint32_t>(spec.gap_te) * te * (100 - kTolerancePct);
+    }
+    if (spec.te_from_gap) {
+        const uint32_t min_us = static_cast<uint32_t>(spec.gap_te) * spec.te_min_us * (100 - kTolerancePct) / 100;
+        const uint32_t max_us = static_cast<uint32_t>(spec.gap_te) * spec.te_max_us * (100 + kTolerancePct) / 100;
+        return duration_us >= min_us && duration_us <= max_us;
+    }
+    if (spec.gap_te && spec.te_us) {
+        return duration_us * 100 >= static_cast<uint32_t>(spec.gap_te) * spec.te_us * (100 - kTolerancePct);
+    }
+    return duration_us >= spec.gap_min_us;
+}
+
+void OokDecoderEngine::start_frame(const OokProtocolSpec &spec, State *state, uint32_t gap_us) {
+    *state = State{};
+    uint32_t te = spec.te_us;
+    if (spec.te_from_gap) {
+        te = gap_us / spec.gap_te;
+        if (te < spec.te_min_us || te > spec.te_max_us) {
+            return;
+        }
+    }
+    state->te_us = static_cast<uint16_t>(te);
+    state->phase = spec.start_high ? PHASE_START : PHASE_FIRST;
+}
+
+bool OokDecoderEngine::close_frame(const OokProtocolSpec &spec, State *state, OokFrame *out_frame) {
+    if (state->phase == PHASE_WAIT_GAP) {
+        return false;
+    }
+    // The last bit lost its low half to the gap: a final high half-bit (Manchester),
+    // or a lone high whose length alone tells short from long (PWM_RATIO).
+    if (spec.coding == OOK_CODING_MANCHESTER && state->half_pending && state->half_level) {
+        append_bit(spec, state, true);
+    } else if (spec.coding == OOK_CODING_PWM_RATIO && state->phase == PHASE_SECOND && state->bit_count > 0) {
+        append_bit(spec, state, !matches(state->first_us, state->te_us));
+    }
+    const bool complete = state->phase != PHASE_WAIT_GAP &&
+                          state->bit_count >= spec.min_bits && state->bit_count <= spec.max_bits;
+    if (complete) {
+        out_frame->protocol = spec.name;
+        out_frame->bit_count = state->bit_count;
+        out_frame->payload = state->payload;
+        out_frame->te_us = state->te_us;
+    }
+    state->phase = PHASE_WAIT_GAP;
+    return complete;
+}
+
+void OokDecoderEngine::append_bit(const OokProtocolSpec &spec, State *state, bool bit) {
+    if (state->bit_count >= spec.max_bits || state->bit_count >= 64) {
+        // Longer than the protocol allows: not this protocol.
+        state->phase = PHASE_WAIT_GAP;
+        return;
+    }
+    state->payload = (state->payload << 1) | (bit ? 1u : 0u);
+    state->bit_count++;
+}
+
+void OokDecoderEngine::step_pwm(const OokProtocolSpec &spec, State *state, bool level, uint32_t duration_us) {
+    const bool first_level = (spec.order == OOK_PAIR_HIGH_LOW);
+    if (state->phase == PHASE_FIRST) {
+        if (level != first_level) {
+            state->phase = PHASE_WAIT_GAP;
+            return;
+        }
+        state->first_us = duration_us;
+        state->phase = PHASE_SECOND;
+        return;
+    }
+
+    state->phase = PHASE_FIRST;
+    const uint32_t first = state->first_us;
+    if (spec.coding == OOK_CODING_PWM) {
+        const uint32_t te = state->te_us;
+        if (matches(first, spec.zero_first * te) && matches(duration_us, spec.zero_second * te)) {
+            append_bit(spec, state, false);
+        } else if (matches(first, spec.one_first * te) && matches(duration_us, spec.one_second * te)) {
+            append_bit(spec, state, true);
+        } else {
+            state->phase = PHASE_WAIT_GAP;
+        }
+        return;
+    }
+
+    // PWM_RATIO: constant period, the high half is either clearly long or clearly short.
+    const uint32_t period = first + duration_us;
+    const uint32_t high = first_level ? first : duration_us;
+    const uint32_t low = first_level ? duration_us : first;
+    const uint32_t longer = (high > low) ? high : low;
+    const uint32_t shorter = (high > low) ? low : high;
+    if (longer * kMinRatioDen < shorter * kMinRatioNum) {
+        state->phase = PHASE_WAIT_GAP;
+        return;
+    }
+    if (state->bit_count == 0) {
+        if (shorter < spec.te_min_us || shorter > spec.te_max_us) {
+            state->phase = PHASE_WAIT_GAP;
+            return;
+        }
+        state->period_us = period;
+        state->te_us = static_cast<uint16_t>(shorter);
+    } else if (!matches(period, state->period_us)) {
+        state->phase = PHASE_WAIT_GAP;
+        return;
+    }
+    append_bit(spec, state, high > low);
+}
+
+void OokDecoderEngine::step_manchester(const OokProtocolSpec &spec, State *state, bool level, uint32_t duration_us) {
+    // The first pulse after the gap is taken as one half-bit and sets te.
+    if (state->te_us == 0) {
+        if (!level || duration_us < spec.te_min_us || duration_us > spec.te_max_us) {
+            state->phase = PHASE_WAIT_GAP;
+            return;
+        }
+        state->te_us = static_cast<uint16_t>(duration_us);
+    }
+
+    uint8_t halves = 0;
+    if (matches(duration_us, state->te_us)) {
+        halves = 1;
+    } else if (matches(duration_us, 2u * state->te_us)) {
+        halves = 2;
+    } else {
+        state->phase = PHASE_WAIT_GAP;
+        return;
+    }
+
+    for (uint8_t h = 0; h < halves && state->phase != PHASE_WAIT_GAP; ++h) {
+        if (!state->half_pending) {
+            state->half_pending = true;
+            state->half_level = level;
+            continue;
+        }
+        state->half_pending = false;
+        // Both halves at the same level: no transition mid-bit, not Manchester.
+        if (state->half_level == level) {
+            state->phase = PHASE_WAIT_GAP;
+            return;
+        }
+        append_bit(spec, state, state->half_level);
+    }
+}
+
+void OokDecoderEngine::push_frame(const OokFrame &frame) {
+    // Oldest frame is overwritten when the reader falls behind.
+    const uint8_t slot = (frame_head_ + frame_count_) % kFrameQueueSize;
+    frames_[slot] = frame;
+    if (frame_count_ < kFrameQueueSize) {
+        frame_count_++;
+    } else {
+        frame_head_ = (frame_head_ + 1) % kFrameQueueSize;
+    }
+}
+
+void OokDecoderEngine::collect(uint8_t index, OokFrame *generic_frames, uint8_t *generic_count, uint8_t *emitted) {
+    OokFrame frame;
+    if (!close_frame(table_[index], &states_[index], &frame)) {
+        return;
+    }
+    if (table_[index].generic) {
+        generic_frames[(*generic_count)++] = frame;
+    } else {
+        push_frame(frame);
+        (*emitted)++;
+    }
+}
+
+uint8_t OokDecoderEngine::publish_generic(const OokFrame *generic_frames, uint8_t generic_count, uint8_t emitted) {
+    // Catch-all decoders only speak when no specific protocol claimed the frame.
+    if (emitted > 0) {
+        return emitted;
+    }
+    for (uint8_t i = 0; i < generic_count; ++i) {
+        push_frame(generic_frames[i]);
+    }
+    return generic_count;
+}
+
+uint8_t OokDecoderEngine::feed(bool level, uint32_t duration_us) {
+    OokFrame generic_frames[kMaxProtocols];
+    uint8_t generic_count = 0;
+    uint8_t emitted = 0;
+
+    for (uint8_t i = 0; i < count_; ++i) {
+        const OokProtocolSpec &spec = table_[i];
+        State &state = states_[i];
+
+        if (is_gap(spec, state, level, duration_us)) {
+            collect(i, generic_frames, &generic_count, &emitted);
+            start_frame(spec, &state, duration_us);
+            continue;
+        }
+
+        switch (state.phase) {
+            case PHASE_START:
+                state.phase = (level && matches(duration_us, static_cast<uint32_t>(spec.start_high) * state.te_us))
+                    ? PHASE_FIRST
+                    : PHASE_WAIT_GAP;
+                break;
+            case PHASE_FIRST:
+            case PHASE_SECOND:
+                if (spec.coding == OOK_CODING_MANCHESTER) {
+                    step_manchester(spec, &state, level, duration_us);
+                } else {
+                    step_pwm(spec, &state, level, duration_us);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    return publish_generic(generic_frames, generic_count, emitted);
+}
+
+uint8_t OokDecoderEngine::flush() {
+    OokFrame generic_frames[kMaxProtocols];
+    uint8_t generic_count = 0;
+    uint8_t emitted = 0;
+    for (uint8_t i = 0; i < count_; ++i) {
+        collect(i, generic_frames, &generic_count, &emitted);
+    }
+    return publish_generic(generic_frames, generic_count, emitted);
+}
+
+bool OokDecoderEngine::pop_frame(OokFrame *out_frame) {
+    if (!out_frame || frame_count_ == 0) {
+        return false;
+    }
+    *out_frame = frames_[frame_head_];
+    frame_head_ = (frame_head_ + 1) % kFrameQueueSize;
+    frame_count_--;
+    return true;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <stdint.h>
+
+enum OokCoding : uint8_t {
+    // Each bit is a pulse pair whose durations (in te units) select 0 or 1.
+    OOK_CODING_PWM = 0,
+    // Each bit is a pulse pair of constant period: the longer half selects the bit.
+    OOK_CODING_PWM_RATIO,
+    // Each bit is two half-bit levels of one te: high-low = 1, low-high = 0.
+    OOK_CODING_MANCHESTER,
+};
+
+enum OokPairOrder : uint8_t {
+    OOK_PAIR_HIGH_LOW = 0,
+    OOK_PAIR_LOW_HIGH,
+};
+
+// Timing table entry. Durations are in te units unless suffixed _us.
+struct OokProtocolSpec {
+    const char *name;
+    OokCoding coding;
+    OokPairOrder order;
+    // Nominal base pulse; 0 means te is learnt from the frame.
+    uint16_t te_us;
+    uint16_t te_min_us;
+    uint16_t te_max_us;
+    // Pair durations for 0 and 1, in pair order (PWM only).
+    uint8_t zero_first;
+    uint8_t zero_second;
+    uint8_t one_first;
+    uint8_t one_second;
+    // Lone high pulse between the gap and the first bit (0 = none).
+    uint8_t start_high;
+    // Low pulse that separates frames: gap_te * te, or gap_min_us when te is learnt.
+    uint8_t gap_te;
+    uint16_t gap_min_us;
+    // te derived from the gap length (gap_te must be exact, e.g. Princeton sync = 31 te).
+    bool te_from_gap;
+    uint8_t min_bits;
+    uint8_t max_bits;
+    // Catch-all decoders only report frames no specific protocol recognised.
+    bool generic;
+};
+
+struct OokFrame {
+    const char *protocol;
+    uint8_t bit_count;
+    // First received bit in the most significant used position.
+    uint64_t payload;
+    uint16_t te_us;
+};
+
+// Built-in table: Princeton (PT2262/EV1527), CAME, Nice FLO, generic PWM, generic Manchester.
+const OokProtocolSpec *ook_protocol_table(uint8_t *out_count);
+
+// Runs every protocol state machine side by side, one pulse at a time: no frame is buffered,
+// a decoder that sees a pulse it cannot explain drops back to waiting for the next gap.
+class OokDecoderEngine {
+public:
+    static constexpr uint8_t kMaxProtocols = 8;
+    static constexpr uint8_t kFrameQueueSize = 4;
+
+    OokDecoderEngine();
+    explicit OokDecoderEngine(const OokProtocolSpec *table, uint8_t count);
+
+    void reset();
+    // level: true for carrier on. Returns the number of frames completed by this pulse.
+    uint8_t feed(bool level, uint32_t duration_us);
+    // Closes frames still open at the end of a capture (equivalent to a trailing gap).
+    uint8_t flush();
+    bool pop_frame(OokFrame *out_frame);
+
+private:
+    struct State {
+        uint8_t phase;
+        uint16_t te_us;
+        uint32_t first_us;
+        uint32_t period_us;
+        uint8_t bit_count;
+        uint64_t payload;
+        // Manchester: a half-bit waiting for its partner.
+        bool half_pending;
+        bool half_level;
+    };
+
+    bool is_gap(const OokProtocolSpec &spec, const State &state, bool level, uint32_t duration_us) const;
+    void start_frame(const OokProtocolSpec &spec, State *state, uint32_t gap_us);
+    bool close_frame(const OokProtocolSpec &spec, State *state, OokFrame *out_frame);
+    void step_pwm(const OokProtocolSpec &spec, State *state, bool level, uint32_t duration_us);
+    void step_manchester(const OokProtocolSpec &spec, State *state, bool level, uint32_t duration_us);
+    void append_bit(const OokProtocolSpec &spec, State *state, bool bit);
+    void push_frame(const OokFrame &frame);
+    // Closes one decoder's frame; generic frames are held back until every decoder has run.
+    void collect(uint8_t index, OokFrame *generic_frames, uint8_t *generic_count, uint8_t *emitted);
+    uint8_t publish_generic(const OokFrame *generic_frames, uint8_t generic_count, uint8_t emitted);
+
+    const OokProtocolSpec *table_;
+    uint8_t count_;
+    State states_[kMaxProtocols];
+    OokFrame frames_[kFrameQueueSize];
+    uint8_t frame_head_ = 0;
+    uint8_t frame_count_ = 0;
+};
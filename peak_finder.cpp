@@ -0,0 +1,125 @@
+#include "peak_finder.h"
+
+namespace {
+
+bool is_local_max(const int16_t *rssi_dbm, uint16_t count, uint16_t i) {
+    const int16_t y = rssi_dbm[i];
+    // Plateaus are tested once, from their first bin, against the first different bin on
+    // each side: a flat step on a rising flank is not a maximum.
+    if (i > 0 && y <= rssi_dbm[i - 1]) {
+        return false;
+    }
+    uint16_t last = i;
+    while (last + 1 < count && rssi_dbm[last + 1] == y) {
+        last++;
+    }
+    return (last + 1 >= count) || (y > rssi_dbm[last + 1]);
+}
+
+SpectrumPeak make_peak(const int16_t *rssi_dbm, uint16_t count, uint16_t i, float start_mhz, float step_mhz) {
+    // Fine sweeps round the top of a carrier to a run of equal dBm readings: it is centred
+    // on the run, and the parabola spans the run out to its first lower neighbours.
+    uint16_t last = i;
+    while (last + 1 < count && rssi_dbm[last + 1] == rssi_dbm[i]) {
+        last++;
+    }
+    const float half_run = 0.5f * static_cast<float>(last - i);
+
+    SpectrumPeak peak;
+    peak.bin = static_cast<uint16_t>(i + (last - i) / 2);
+    peak.position = static_cast<float>(i) + half_run;
+    peak.rssi_dbm = static_cast<float>(rssi_dbm[i]);
+
+    // Edge runs have no neighbour on one side and keep the run centre.
+    if (i > 0 && last + 1 < count) {
+        float height = peak.rssi_dbm;
+        const float offset = peak_interpolate_parabolic(rssi_dbm[i - 1], rssi_dbm[i], rssi_dbm[last + 1], &height);
+        peak.position += offset * (half_run + 1.0f);
+        peak.rssi_dbm = height;
+    }
+    peak.freq_mhz = start_mhz + peak.position * step_mhz;
+    return peak;
+}
+
+uint16_t bin_distance(uint16_t a, uint16_t b) {
+    return (a > b) ? a - b : b - a;
+}
+
+}  // namespace
+
+float peak_interpolate_parabolic(float y_left, float y_center, float y_right, float *out_peak) {
+    const float denom = y_left - 2.0f * y_center + y_right;
+    float offset = 0.0f;
+    // Flat or convex neighbourhood: keep the centre bin.
+    if (denom < 0.0f) {
+        offset = 0.5f * (y_left - y_right) / denom;
+        if (offset > 0.5f) {
+            offset = 0.5f;
+        } else if (offset < -0.5f) {
+            offset = -0.5f;
+        }
+    }
+    if (out_peak) {
+        *out_peak = y_center - 0.25f * (y_left - y_right) * offset;
+    }
+    return offset;
+}
+
+uint8_t peak_find_top_k(const int16_t *rssi_dbm,
+                        uint16_t count,
+                        float start_mhz,
+                        float step_mhz,
+                        int16_t min_rssi_dbm,
+                        uint16_t min_separation_bins,
+                        SpectrumPeak *out_peaks,
+                        uint8_t max_peaks) {
+    if (!rssi_dbm || !out_peaks || count == 0 || max_peaks == 0) {
+        return 0;
+    }
+
+    uint8_t found = 0;
+    for (uint16_t i = 0; i < count; ++i) {
+        if (rssi_dbm[i] < min_rssi_dbm || !is_local_max(rssi_dbm, count, i)) {
+            continue;
+        }
+
+        // A stronger peak nearby wins; a weaker one nearby is replaced.
+        bool suppressed = false;
+        uint8_t p = 0;
+        while (p < found) {
+            if (bin_distance(out_peaks[p].bin, i) >= min_separation_bins) {
+                p++;
+                continue;
+            }
+            if (rssi_dbm[out_peaks[p].bin] >= rssi_dbm[i]) {
+                suppressed = true;
+                break;
+            }
+            for (uint8_t q = p; q + 1 < found; ++q) {
+                out_peaks[q] = out_peaks[q + 1];
+            }
+            found--;
+        }
+        if (suppressed) {
+            continue;
+        }
+
+        // Insertion into the list kept sorted by descending raw RSSI.
+        uint8_t pos = found;
+        while (pos > 0 && rssi_dbm[out_peaks[pos - 1].bin] < rssi_dbm[i]) {
+            pos--;
+        }
+        if (pos >= max_peaks) {
+            continue;
+        }
+        const uint8_t last = (found < max_peaks) ? found : max_peaks - 1;
+        for (uint8_t q = last; q > pos; --q) {
+            out_peaks[q] = out_peaks[q - 1];
+        }
+        out_peaks[pos] = make_peak(rssi_dbm, count, i, start_mhz, step_mhz);
+        if (found < max_peaks) {
+            found++;
+        }
+    }
+    return found;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+
+// One emitter found in a sweep, at sub-bin resolution.
+struct SpectrumPeak {
+    uint16_t bin;
+    // Fractional bin position of the interpolated maximum. Within half a bin of bin, or
+    // within the run when several equal bins share the maximum (bin is then its centre).
+    float position;
+    float freq_mhz;
+    float rssi_dbm;
+};
+
+// Parabola through three bins around a local maximum. RSSI is already in dB, so this is
+// the Gaussian interpolation of the linear power spectrum. Returns the vertex offset from
+// the centre bin in [-0.5, 0.5] and writes the vertex height to out_peak when non-null.
+float peak_interpolate_parabolic(float y_left, float y_center, float y_right, float *out_peak);
+
+// Local maxima at or above min_rssi_dbm, strongest first, at least min_separation_bins apart.
+// Frequencies follow the uniform sweep grid start_mhz + position * step_mhz.
+// Returns the number of peaks written (<= max_peaks).
+uint8_t peak_find_top_k(const int16_t *rssi_dbm,
+                        uint16_t count,
+                        float start_mhz,
+                        float step_mhz,
+                        int16_t min_rssi_dbm,
+                        uint16_t min_separation_bins,
+                        SpectrumPeak *out_peaks,
+                        uint8_t max_peaks);
@@ -1,5 +1,6 @@
 #include "power_manager.h"
 
+#include "energy_accounting.h"
 #include "esp_io_expander_tca9554.h"
 #include "i2c_bsp.h"
 #include "lcd_bl_pwm_bsp.h"
@@ -38,6 +39,7 @@ void amp_on() {
     }
     esp_io_expander_set_level(power_io_expander, IO_EXPANDER_PIN_NUM_7, 1);
     amp_active = true;
+    energy_accounting_set_level(ENERGY_RAIL_AMP, ENERGY_LEVEL_FULL);
 }
 
 void amp_off() {
@@ -46,6 +48,7 @@ void amp_off() {
     }
     esp_io_expander_set_level(power_io_expander, IO_EXPANDER_PIN_NUM_7, 0);
     amp_active = false;
+    energy_accounting_set_level(ENERGY_RAIL_AMP, ENERGY_LEVEL_OFF);
 }
 
 void init_latch() {
@@ -81,16 +84,19 @@ void init_latch() {
     esp_io_expander_set_level(power_io_expander, IO_EXPANDER_PIN_NUM_7, 1);
     latch_active = true;
     amp_active = true;
+    energy_accounting_set_level(ENERGY_RAIL_AMP, ENERGY_LEVEL_FULL);
     Serial.println("[LATCH] Latch initialise et active");
     Serial.println("[AMP] ON");
 }
 
 void backlight_on() {
     setUpduty(LCD_PWM_MODE_255);
+    energy_accounting_set_level(ENERGY_RAIL_BACKLIGHT, LCD_PWM_MODE_255);
 }
 
 void backlight_off() {
     setUpduty(LCD_PWM_MODE_0);
+    energy_accounting_set_level(ENERGY_RAIL_BACKLIGHT, LCD_PWM_MODE_0);
 }
 
 }  // namespace
@@ -0,0 +1,143 @@
+#include "pulse_buffer_pool.h"
+
+bool PulseBufferPool::init(uint32_t *storage, uint8_t block_count, uint16_t symbols_per_block) {
+    if (!storage || block_count == 0 || block_count > kMaxBlocks || symbols_per_block == 0) {
+        return false;
+    }
+    block_count_ = block_count;
+    for (uint8_t i = 0; i < block_count_; ++i) {
+        PulseBlock &block = blocks_[i];
+        block.symbols = storage + static_cast<size_t>(i) * symbols_per_block;
+        block.capacity_symbols = symbols_per_block;
+        block.symbol_count = 0;
+        block.timestamp_ms = 0;
+        block.frequency_hz = 0;
+        block.sequence = 0;
+        block.state.store(PULSE_BLOCK_FREE);
+    }
+    return true;
+}
+
+bool PulseBufferPool::transition(PulseBlock *block, PulseBlockState from, PulseBlockState to) {
+    if (!block) {
+        return false;
+    }
+    uint8_t expected = from;
+    return block->state.compare_exchange_strong(expected, to, std::memory_order_acq_rel);
+}
+
+PulseBlock *PulseBufferPool::acquire() {
+    for (uint8_t i = 0; i < block_count_; ++i) {
+        if (transition(&blocks_[i], PULSE_BLOCK_FREE, PULSE_BLOCK_FILLING)) {
+            blocks_[i].symbol_count = 0;
+            return &blocks_[i];
+        }
+    }
+    return nullptr;
+}
+
+void PulseBufferPool::commit(PulseBlock *block, uint16_t symbol_count, uint32_t timestamp_ms) {
+    if (!block) {
+        return;
+    }
+    block->symbol_count = (symbol_count > block->capacity_symbols) ? block->capacity_symbols : symbol_count;
+    block->timestamp_ms = timestamp_ms;
+    block->sequence = next_sequence_.fetch_add(1, std::memory_order_relaxed);
+    transition(block, PULSE_BLOCK_FILLING, PULSE_BLOCK_READY);
+}
+
+void PulseBufferPool::abandon(PulseBlock *block) {
+    transition(block, PULSE_BLOCK_FILLING, PULSE_BLOCK_FREE);
+}
+
+PulseBlock *PulseBufferPool::take_ready() {
+    // Retries when another consumer wins the race for the oldest block.
+    while (true) {
+        PulseBlock *oldest = nullptr;
+        for (uint8_t i = 0; i < block_count_; ++i) {
+            PulseBlock &block = blocks_[i];
+            if (block.state.load(std::memory_order_acquire) != PULSE_BLOCK_READY) {
+                continue;
+            }
+            // Wrap-safe sequence comparison.
+            if (!oldest || static_cast<int32_t>(block.sequence - oldest->sequence) < 0) {
+                oldest = &block;
+            }
+        }
+        if (!oldest) {
+            return nullptr;
+        }
+        if (transition(oldest, PULSE_BLOCK_READY, PULSE_BLOCK_IN_USE)) {
+            return oldest;
+        }
+    }
+}
+
+void PulseBufferPool::release(PulseBlock *block) {
+    transition(block, PULSE_BLOCK_IN_USE, PULSE_BLOCK_FREE);
+}
+
+uint8_t PulseBufferPool::discard_ready() {
+    uint8_t count = 0;
+    while (PulseBlock *stale = take_ready()) {
+        release(stale);
+        count++;
+    }
+    return count;
+}
+
+uint8_t PulseBufferPool::count_in_state(PulseBlockState state) const {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < block_count_; ++i) {
+        if (blocks_[i].state.load(std::memory_order_relaxed) == state) {
+            count++;
+        }
+    }
+    return count;
+}
+
+PulseTrain::PulseTrain(const PulseBlock &block) : symbols_(block.symbols), size_(0) {
+    const uint32_t max_pulses = static_cast<uint32_t>(block.symbol_count) * 2;
+    while (size_ < max_pulses && (half(size_) & PULSE_MAX_DURATION_US) != 0) {
+        size_++;
+    }
+}
+
+uint16_t PulseTrain::half(uint16_t index) const {
+    const uint32_t word = symbols_[index / 2];
+    return static_cast<uint16_t>((index & 1) ? (word >> 16) : (word & 0xFFFF));
+}
+
+uint16_t PulseTrain::duration_us(uint16_t index) const {
+    return (index < size_) ? (half(index) & PULSE_MAX_DURATION_US) : 0;
+}
+
+bool PulseTrain::level(uint16_t index) const {
+    return (index < size_) && (half(index) & 0x8000);
+}
+
+uint16_t pulse_block_encode(PulseBlock *block, const uint16_t *durations_us, bool first_level, uint16_t count) {
+    if (!block || !durations_us) {
+        return 0;
+    }
+
+    const uint32_t max_pulses = static_cast<uint32_t>(block->capacity_symbols) * 2;
+    uint16_t stored = 0;
+    bool level = first_level;
+    for (uint16_t i = 0; i < count && stored < max_pulses; ++i) {
+        uint16_t duration = durations_us[i];
+        if (duration == 0) {
+            break;
+        }
+        if (duration > PULSE_MAX_DURATION_US) {
+            duration = PULSE_MAX_DURATION_US;
+        }
+        const uint32_t half = duration | (level ? 0x8000u : 0u);
+        uint32_t &word = block->symbols[stored / 2];
+        word = (stored & 1) ? ((word & 0xFFFF) | (half << 16)) : half;
+        stored++;
+        level = !level;
+    }
+    block->symbol_count = static_cast<uint16_t>((stored + 1) / 2);
+    return stored;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Pulses are stored in the RMT symbol layout so the hardware writes them in place:
+// one 32-bit word = {duration0:15, level0:1, duration1:15, level1:1}, durations in ticks (1 us).
+constexpr uint16_t PULSE_MAX_DURATION_US = 0x7FFF;
+
+enum PulseBlockState : uint8_t {
+    PULSE_BLOCK_FREE = 0,
+    // Owned by the producer (RMT driver or test injector).
+    PULSE_BLOCK_FILLING,
+    // Complete, waiting for a consumer.
+    PULSE_BLOCK_READY,
+    // Handed to a consumer until release().
+    PULSE_BLOCK_IN_USE,
+};
+
+struct PulseBlock {
+    uint32_t *symbols;
+    uint16_t capacity_symbols;
+    uint16_t symbol_count;
+    uint32_t timestamp_ms;
+    uint32_t frequency_hz;
+    uint32_t sequence;
+    std::atomic<uint8_t> state;
+};
+
+// Fixed pool of pulse blocks over caller-supplied storage (DMA-capable RAM on target).
+// Blocks move FREE -> FILLING -> READY -> IN_USE -> FREE; each transition is a single atomic
+// compare-exchange, so commit() may run from an ISR while a task consumes.
+class PulseBufferPool {
+public:
+    static constexpr uint8_t kMaxBlocks = 8;
+
+    static size_t storage_bytes(uint8_t block_count, uint16_t symbols_per_block) {
+        return static_cast<size_t>(block_count) * symbols_per_block * sizeof(uint32_t);
+    }
+
+    bool init(uint32_t *storage, uint8_t block_count, uint16_t symbols_per_block);
+
+    // Producer side.
+    PulseBlock *acquire();
+    void commit(PulseBlock *block, uint16_t symbol_count, uint32_t timestamp_ms);
+    void abandon(PulseBlock *block);
+
+    // Consumer side: oldest ready block first, read in place, then released.
+    PulseBlock *take_ready();
+    void release(PulseBlock *block);
+    // Frees every READY block nobody took; returns how many. For a consumer that gave up
+    // waiting before the producer committed.
+    uint8_t discard_ready();
+
+    uint8_t block_count() const {
+        return block_count_;
+    }
+    uint8_t count_in_state(PulseBlockState state) const;
+
+private:
+    bool transition(PulseBlock *block, PulseBlockState from, PulseBlockState to);
+
+    PulseBlock blocks_[kMaxBlocks];
+    uint8_t block_count_ = 0;
+    std::atomic<uint32_t> next_sequence_{0};
+};
+
+// Read-only pulse view of one block: pulse i alternates between the two halves of symbol i / 2.
+// A zero duration marks the end of the received data.
+class PulseTrain {
+public:
+    explicit PulseTrain(const PulseBlock &block);
+
+    uint16_t size() const {
+        return size_;
+    }
+    uint16_t duration_us(uint16_t index) const;
+    bool level(uint16_t index) const;
+
+private:
+    uint16_t half(uint16_t index) const;
+
+    const uint32_t *symbols_;
+    uint16_t size_;
+};
+
+// Fills a FILLING block from a level/duration list, as the RMT would. For host-side injection.
+// Returns the number of pulses stored.
+uint16_t pulse_block_encode(PulseBlock *block, const uint16_t *durations_us, bool first_level, uint16_t count);
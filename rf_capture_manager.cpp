@@ -0,0 +1,159 @@
+#include "rf_capture_manager.h"
+
+#include "driver/rmt_rx.h"
+#include "esp_heap_caps.h"
+
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+namespace {
+
+// 1 tick = 1 us, the 15-bit duration field then covers pulses up to 32 ms.
+constexpr uint32_t kRmtResolutionHz = 1000000;
+constexpr uint8_t kPoolBlocks = 4;
+// 1024 pulses: several repeats of a 24-bit Princeton frame.
+constexpr uint16_t kBlockSymbols = 512;
+// Without a DMA channel the frame has to fit the RMT RAM of the RX channel.
+constexpr uint16_t kNoDmaBlockSymbols = 96;
+// Shorter pulses are dropped by the RMT glitch filter (close to its upper bound).
+constexpr uint32_t kGlitchFilterNs = 3000;
+// A quiet line this long ends the receive. It must outlast every gap inside a transmission,
+// including the Princeton sync (31 te, up to ~29 ms at te = 700 us with tolerance) which is
+// also the repeat gap, so repeats land in one block; the 15-bit field caps it at 32.7 ms.
+constexpr uint32_t kIdleThresholdNs = 30UL * 1000UL * 1000UL;
+static_assert(kIdleThresholdNs / 1000UL * (kRmtResolutionHz / 1000000UL) <= 32767UL,
+              "idle threshold exceeds the RMT duration field");
+
+rmt_channel_handle_t rx_channel = nullptr;
+PulseBufferPool pool;
+SemaphoreHandle_t frame_ready = nullptr;
+std::atomic<PulseBlock *> armed_block{nullptr};
+uint16_t block_symbols = kBlockSymbols;
+
+bool IRAM_ATTR on_recv_done(rmt_channel_handle_t channel, const rmt_rx_done_event_data_t *edata, void *ctx) {
+    (void)channel;
+    (void)ctx;
+    BaseType_t woken = pdFALSE;
+    PulseBlock *block = armed_block.exchange(nullptr);
+    if (block) {
+        pool.commit(block,
+                    static_cast<uint16_t>(edata->num_symbols),
+                    xTaskGetTickCountFromISR() * portTICK_PERIOD_MS);
+        xSemaphoreGiveFromISR(frame_ready, &woken);
+    }
+    return woken == pdTRUE;
+}
+
+bool create_channel(int gdo0_gpio, bool with_dma) {
+    rmt_rx_channel_config_t config = {};
+    config.gpio_num = static_cast<gpio_num_t>(gdo0_gpio);
+    config.clk_src = RMT_CLK_SRC_DEFAULT;
+    config.resolution_hz = kRmtResolutionHz;
+    config.mem_block_symbols = with_dma ? kBlockSymbols : kNoDmaBlockSymbols;
+    config.flags.with_dma = with_dma;
+    return rmt_new_rx_channel(&config, &rx_channel) == ESP_OK;
+}
+
+}  // namespace
+
+bool rf_capture_manager_init(int gdo0_gpio) {
+    if (rx_channel) {
+        return true;
+    }
+
+    if (!create_channel(gdo0_gpio, true)) {
+        Serial.println("[RMT] DMA indisponible, capture limitee a la RAM RMT");
+        block_symbols = kNoDmaBlockSymbols;
+        if (!create_channel(gdo0_gpio, false)) {
+            Serial.println("[RMT] ERREUR: canal RX indisponible");
+            return false;
+        }
+    }
+
+    // The RMT (or its DMA) writes straight into pool storage: internal, DMA-capable RAM.
+    uint32_t *storage = static_cast<uint32_t *>(
+        heap_caps_malloc(PulseBufferPool::storage_bytes(kPoolBlocks, block_symbols),
+                         MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL));
+    frame_ready = xSemaphoreCreateBinary();
+    if (!storage || !frame_ready || !pool.init(storage, kPoolBlocks, block_symbols)) {
+        Serial.println("[RMT] ERREUR: allocation des tampons");
+        return false;
+    }
+
+    rmt_rx_event_callbacks_t callbacks = {};
+    callbacks.on_recv_done = on_recv_done;
+    if (rmt_rx_register_event_callbacks(rx_channel, &callbacks, nullptr) != ESP_OK ||
+        rmt_enable(rx_channel) != ESP_OK) {
+        Serial.println("[RMT] ERREUR: activation du canal RX");
+        return false;
+    }
+
+    Serial.printf("[RMT] Capture GDO0 prete (GPIO %d, %u blocs x %u impulsions)\n",
+                  gdo0_gpio,
+                  static_cast<unsigned>(kPoolBlocks),
+                  static_cast<unsigned>(block_symbols * 2));
+    return true;
+}
+
+bool rf_capture_manager_arm(uint32_t frequency_hz) {
+    if (!rx_channel || armed_block.load()) {
+        return false;
+    }
+
+    // A receive that completed after the last take() timed out (before disarm) left a READY
+    // block tagged with the previous frequency; take() would hand it out instead of waiting.
+    pool.discard_ready();
+
+    PulseBlock *block = pool.acquire();
+    if (!block) {
+        // Every block is still held by a consumer.
+        return false;
+    }
+    block->frequency_hz = frequency_hz;
+    // Drop a wake-up left by a frame that was already consumed.
+    xSemaphoreTake(frame_ready, 0);
+    armed_block.store(block);
+
+    rmt_receive_config_t config = {};
+    config.signal_range_min_ns = kGlitchFilterNs;
+    config.signal_range_max_ns = kIdleThresholdNs;
+    if (rmt_receive(rx_channel, block->symbols, block->capacity_symbols * sizeof(uint32_t), &config) != ESP_OK) {
+        armed_block.store(nullptr);
+        pool.abandon(block);
+        return false;
+    }
+    return true;
+}
+
+PulseBlock *rf_capture_manager_take(uint32_t timeout_ms) {
+    if (!frame_ready) {
+        return nullptr;
+    }
+    PulseBlock *block = pool.take_ready();
+    if (block) {
+        return block;
+    }
+    if (xSemaphoreTake(frame_ready, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
+        return nullptr;
+    }
+    return pool.take_ready();
+}
+
+void rf_capture_manager_release(PulseBlock *block) {
+    pool.release(block);
+}
+
+void rf_capture_manager_disarm() {
+    if (!rx_channel || !armed_block.load()) {
+        return;
+    }
+    // Disabling the channel aborts the pending receive; the done callback will not fire.
+    rmt_disable(rx_channel);
+    PulseBlock *block = armed_block.exchange(nullptr);
+    if (block) {
+        pool.abandon(block);
+    }
+    rmt_enable(rx_channel);
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "pulse_buffer_pool.h"
+
+#include <stdint.h>
+
+// Hardware capture of the CC1101 asynchronous data output (GDO0) with the RMT receiver:
+// edges are timestamped at 1 us by the RMT and written by DMA straight into pool blocks.
+bool rf_capture_manager_init(int gdo0_gpio);
+// Starts one frame capture; the radio must already be in RX on frequency_hz.
+bool rf_capture_manager_arm(uint32_t frequency_hz);
+// Waits for a captured frame. The block is read in place and stays valid until released.
+PulseBlock *rf_capture_manager_take(uint32_t timeout_ms);
+void rf_capture_manager_release(PulseBlock *block);
+// Cancels a capture that received nothing.
+void rf_capture_manager_disarm();
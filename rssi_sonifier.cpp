@@ -0,0 +1,174 @@
+#include "rssi_sonifier.h"
+
+#include <math.h>
+
+namespace {
+
+// Click burst decays to ~1% within 2 ms at 16 kHz.
+constexpr int32_t kClickDecayQ15 = 28500;
+
+int16_t clamp_s16(int32_t value) {
+    if (value > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (value < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return static_cast<int16_t>(value);
+}
+
+// min * (max / min)^level: equal RSSI steps give equal musical intervals / rate ratios.
+uint32_t exp_map(uint32_t min_value, uint32_t max_value, int32_t level_q15) {
+    if (min_value == 0 || max_value <= min_value) {
+        return min_value;
+    }
+    const float ratio = static_cast<float>(max_value) / static_cast<float>(min_value);
+    return static_cast<uint32_t>(static_cast<float>(min_value) * powf(ratio, level_q15 / 32767.0f));
+}
+
+}  // namespace
+
+SonifierConfig RssiSonifier::default_config(uint32_t sample_rate) {
+    SonifierConfig config = {};
+    config.sample_rate = sample_rate;
+    config.rssi_min_dbm = -100;
+    config.rssi_max_dbm = -30;
+    config.pitch_min_hz = 300;
+    config.pitch_max_hz = 2400;
+    config.click_rate_min_mhz = 500;
+    config.click_rate_max_mhz = 80000;
+    config.click_tone_hz = 3000;
+    config.gain_q15 = tone_gain_q15(0.30f);
+    return config;
+}
+
+void RssiSonifier::configure(const SonifierConfig &config) {
+    tone_synth_init();
+    config_ = config;
+    if (config_.rssi_max_dbm <= config_.rssi_min_dbm) {
+        config_.rssi_max_dbm = static_cast<int16_t>(config_.rssi_min_dbm + 1);
+    }
+    click_osc_.set_frequency(config_.click_tone_hz, config_.sample_rate);
+    params_.store(pack(SONIFY_OFF, config_.rssi_min_dbm - 1), std::memory_order_release);
+}
+
+uint32_t RssiSonifier::pack(SonifyMode mode, int rssi_dbm) {
+    return (static_cast<uint32_t>(mode) << 16) | static_cast<uint16_t>(static_cast<int16_t>(rssi_dbm));
+}
+
+void RssiSonifier::set_mode(SonifyMode mode) {
+    if (mode >= SONIFY_MODE_COUNT) {
+        return;
+    }
+    uint32_t expected = params_.load(std::memory_order_relaxed);
+    while (!params_.compare_exchange_weak(expected,
+                                          (expected & 0xFFFFu) | (static_cast<uint32_t>(mode) << 16),
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed)) {
+    }
+}
+
+void RssiSonifier::publish_rssi(int rssi_dbm) {
+    uint32_t expected = params_.load(std::memory_order_relaxed);
+    while (!params_.compare_exchange_weak(expected,
+                                          (expected & 0xFF0000u) | static_cast<uint16_t>(static_cast<int16_t>(rssi_dbm)),
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed)) {
+    }
+}
+
+SonifyMode RssiSonifier::mode() const {
+    return static_cast<SonifyMode>((params_.load(std::memory_order_acquire) >> 16) & 0xFF);
+}
+
+bool RssiSonifier::idle() const {
+    return mode() == SONIFY_OFF && tone_gain_q15_ == 0 && click_env_q15_ == 0;
+}
+
+uint32_t RssiSonifier::next_random() {
+    // xorshift32
+    uint32_t x = random_state_;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    random_state_ = x;
+    return x;
+}
+
+int32_t RssiSonifier::level_q15(int rssi_dbm) const {
+    if (rssi_dbm <= config_.rssi_min_dbm) {
+        return 0;
+    }
+    if (rssi_dbm >= config_.rssi_max_dbm) {
+        return 32767;
+    }
+    return ((rssi_dbm - config_.rssi_min_dbm) * 32767) / (config_.rssi_max_dbm - config_.rssi_min_dbm);
+}
+
+void RssiSonifier::render(int16_t *out, uint32_t frames) {
+    if (!out || frames == 0) {
+        return;
+    }
+
+    // One parameter snapshot per chunk.
+    const uint32_t params = params_.load(std::memory_order_acquire);
+    const SonifyMode mode = static_cast<SonifyMode>((params >> 16) & 0xFF);
+    const int rssi_dbm = static_cast<int16_t>(params & 0xFFFF);
+    const int32_t level = level_q15(rssi_dbm);
+    const bool above_min = rssi_dbm > config_.rssi_min_dbm;
+
+    int32_t target_gain = 0;
+    uint32_t target_step = tone_.phase_step();
+    if (mode == SONIFY_PITCH && above_min) {
+        pitch_hz_ = exp_map(config_.pitch_min_hz, config_.pitch_max_hz, level);
+        target_step = ToneOscillator::step_for(pitch_hz_, config_.sample_rate);
+        target_gain = config_.gain_q15;
+        // Starting from silence: begin at the new pitch instead of gliding from a stale one.
+        if (tone_gain_q15_ == 0) {
+            tone_.set_phase_step(target_step);
+        }
+    } else {
+        pitch_hz_ = 0;
+    }
+
+    click_rate_mhz_ = (mode == SONIFY_CLICKS)
+        ? exp_map(config_.click_rate_min_mhz, config_.click_rate_max_mhz, level)
+        : 0;
+    // Per-sample click probability on the 2^32 scale of next_random().
+    const uint32_t click_threshold = static_cast<uint32_t>(
+        (static_cast<uint64_t>(click_rate_mhz_) << 32) / (1000ULL * config_.sample_rate));
+
+    // Gain and pitch glide linearly across the chunk; the phase keeps running.
+    const int32_t start_gain = tone_gain_q15_;
+    const int64_t start_step = tone_.phase_step();
+    const int64_t step_delta = static_cast<int64_t>(target_step) - start_step;
+    for (uint32_t i = 0; i < frames; ++i) {
+        const int32_t gain = start_gain + ((target_gain - start_gain) * static_cast<int32_t>(i + 1)) /
+                                              static_cast<int32_t>(frames);
+        tone_.set_phase_step(static_cast<uint32_t>(start_step + (step_delta * (i + 1)) / frames));
+        int32_t sample = (gain > 0) ? tone_.next(static_cast<int16_t>(gain)) : 0;
+
+        if (click_threshold > 0 && next_random() < click_threshold) {
+            click_osc_.reset_phase();
+            click_env_q15_ = config_.gain_q15;
+        }
+        if (click_env_q15_ > 0) {
+            sample += click_osc_.next(static_cast<int16_t>(click_env_q15_));
+            click_env_q15_ = (click_env_q15_ * kClickDecayQ15) >> 15;
+        }
+        out[i] = clamp_s16(sample);
+    }
+    tone_gain_q15_ = target_gain;
+}
+
+const char *sonify_mode_name(SonifyMode mode) {
+    switch (mode) {
+        case SONIFY_PITCH:
+            return "Tonalite";
+        case SONIFY_CLICKS:
+            return "Geiger";
+        case SONIFY_OFF:
+        default:
+            return "Off";
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "tone_synth.h"
+
+#include <atomic>
+#include <stdint.h>
+
+enum SonifyMode : uint8_t {
+    SONIFY_OFF = 0,
+    // Continuous tone, pitch rising with RSSI.
+    SONIFY_PITCH,
+    // Geiger counter: random clicks, rate rising with RSSI.
+    SONIFY_CLICKS,
+    SONIFY_MODE_COUNT,
+};
+
+struct SonifierConfig {
+    uint32_t sample_rate;
+    // RSSI range mapped onto the pitch / click-rate range; below the minimum the tone is muted
+    // and clicks fall back to the minimum rate.
+    int16_t rssi_min_dbm;
+    int16_t rssi_max_dbm;
+    uint16_t pitch_min_hz;
+    uint16_t pitch_max_hz;
+    uint32_t click_rate_min_mhz;  // milli-Hz
+    uint32_t click_rate_max_mhz;
+    uint16_t click_tone_hz;
+    int16_t gain_q15;
+};
+
+// RSSI-to-audio mapping. Producers publish mode and RSSI through one atomic word (no lock, no
+// tearing); render() picks the latest value up at the start of each chunk and glides towards it
+// within that chunk, keeping oscillator phase across chunks. Plain C++: render into a buffer to
+// measure it on the host.
+class RssiSonifier {
+public:
+    static SonifierConfig default_config(uint32_t sample_rate);
+
+    void configure(const SonifierConfig &config);
+
+    // Producer side, any task.
+    void set_mode(SonifyMode mode);
+    void publish_rssi(int rssi_dbm);
+    SonifyMode mode() const;
+
+    // Consumer side: mono frames. Latency from publish to audible change is one chunk.
+    void render(int16_t *out, uint32_t frames);
+    // Mode off and the last fade finished: nothing left to render.
+    bool idle() const;
+
+    // Current synthesis targets, for inspection.
+    uint32_t pitch_hz() const {
+        return pitch_hz_;
+    }
+    uint32_t click_rate_mhz() const {
+        return click_rate_mhz_;
+    }
+
+private:
+    static uint32_t pack(SonifyMode mode, int rssi_dbm);
+    uint32_t next_random();
+    // 0..32767 position of rssi in the configured range.
+    int32_t level_q15(int rssi_dbm) const;
+
+    SonifierConfig config_ = {};
+    std::atomic<uint32_t> params_{0};
+
+    // Consumer-private synthesis state.
+    ToneOscillator tone_;
+    ToneOscillator click_osc_;
+    uint32_t pitch_hz_ = 0;
+    int32_t tone_gain_q15_ = 0;
+    int32_t click_env_q15_ = 0;
+    uint32_t click_rate_mhz_ = 0;
+    uint32_t random_state_ = 0x9E3779B9u;
+};
+
+const char *sonify_mode_name(SonifyMode mode);
@@ -0,0 +1,57 @@
+#include "scan_pacer.h"
+
+void ScanPacer::configure(const ScanPacingConfig &config) {
+    config_ = config;
+    if (config_.value == 0) {
+        config_.value = 1;
+    }
+    if (config_.mode == SCAN_PACING_DUTY && config_.value > 100) {
+        config_.value = 100;
+    }
+    reset_stats();
+}
+
+void ScanPacer::reset_stats() {
+    in_window_ = false;
+    window_busy_us_ = 0;
+    window_passes_ = 0;
+}
+
+void ScanPacer::begin_pass(uint32_t now_us) {
+    pass_start_us_ = now_us;
+    if (!in_window_) {
+        in_window_ = true;
+        window_start_us_ = now_us;
+        window_busy_us_ = 0;
+        window_passes_ = 0;
+        return;
+    }
+
+    // Windows close on a pass boundary, so the idle after the last pass is counted too.
+    const uint32_t wall_us = now_us - window_start_us_;
+    if (wall_us >= kStatsWindowUs) {
+        passes_per_second_ = static_cast<float>(window_passes_) * 1e6f / static_cast<float>(wall_us);
+        const uint64_t permille = static_cast<uint64_t>(window_busy_us_) * 1000ULL / wall_us;
+        busy_permille_ = static_cast<uint16_t>(permille > 1000 ? 1000 : permille);
+        window_start_us_ = now_us;
+        window_busy_us_ = 0;
+        window_passes_ = 0;
+    }
+}
+
+uint32_t ScanPacer::end_pass(uint32_t now_us) {
+    last_pass_us_ = now_us - pass_start_us_;
+    window_busy_us_ += last_pass_us_;
+    window_passes_++;
+
+    uint32_t idle_us = 0;
+    if (config_.mode == SCAN_PACING_RATE) {
+        const uint32_t period_us = 1000000UL / config_.value;
+        idle_us = (last_pass_us_ < period_us) ? period_us - last_pass_us_ : 0;
+    } else {
+        // busy / (busy + idle) = duty
+        idle_us = static_cast<uint32_t>(static_cast<uint64_t>(last_pass_us_) * (100 - config_.value) /
+                                        config_.value);
+    }
+    return (idle_us < config_.min_idle_us) ? config_.min_idle_us : idle_us;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdint.h>
+
+enum ScanPacingMode : uint8_t {
+    // value = passes per second; idle fills the rest of each period.
+    SCAN_PACING_RATE = 0,
+    // value = radio busy percentage; idle is proportional to the pass just done.
+    SCAN_PACING_DUTY,
+};
+
+struct ScanPacingConfig {
+    ScanPacingMode mode;
+    uint16_t value;
+    // Floor on the idle time after every pass, so lower-priority tasks on the core still run.
+    uint32_t min_idle_us;
+};
+
+// Paces back-to-back radio passes from a time budget instead of a fixed sleep,
+// and measures the achieved pass rate and radio busy ratio over one-second windows.
+class ScanPacer {
+public:
+    static constexpr uint32_t kStatsWindowUs = 1000000;
+
+    void configure(const ScanPacingConfig &config);
+    const ScanPacingConfig &config() const {
+        return config_;
+    }
+
+    void begin_pass(uint32_t now_us);
+    // Returns how long to stay idle before the next begin_pass().
+    uint32_t end_pass(uint32_t now_us);
+    // Drops the current window, e.g. after the loop was parked or switched mode.
+    void reset_stats();
+
+    // Values from the last completed window (zero until one completes).
+    float passes_per_second() const {
+        return passes_per_second_;
+    }
+    // Radio busy time over wall time, in 1/10 %.
+    uint16_t busy_permille() const {
+        return busy_permille_;
+    }
+    uint32_t last_pass_us() const {
+        return last_pass_us_;
+    }
+
+private:
+    ScanPacingConfig config_ = {SCAN_PACING_DUTY, 100, 1000};
+    bool in_window_ = false;
+    uint32_t pass_start_us_ = 0;
+    uint32_t window_start_us_ = 0;
+    uint32_t window_busy_us_ = 0;
+    uint32_t window_passes_ = 0;
+    uint32_t last_pass_us_ = 0;
+    float passes_per_second_ = 0.0f;
+    uint16_t busy_permille_ = 0;
+};
@@ -0,0 +1,418 @@
+#include "spectrum_view.h"
+
+#include "esp_heap_caps.h"
+
+#include <Arduino.h>
+
+namespace {
+
+constexpr int32_t kBorderWidth = 1;
+constexpr int32_t kBarGap = 1;
+constexpr int32_t kMinBarHeight = 2;
+constexpr uint32_t kColorIdle = 0x1E88E5;
+constexpr uint32_t kColorSignal = 0xF05A28;
+constexpr int32_t kTraceMarkerHeight = 2;
+constexpr int kLutSize = 128;
+// Waterfall palette stops from weakest to strongest RSSI.
+constexpr uint32_t kWaterfallStops[] = {0x0B1E5B, 0x1E88E5, 0x00E5FF, 0xFFEB3B, 0xF05A28};
+
+enum TraceKind : uint8_t {
+    TRACE_PEAK = 0,
+    TRACE_AVG,
+    TRACE_MIN,
+    TRACE_KIND_COUNT,
+};
+constexpr uint32_t kTraceColors[TRACE_KIND_COUNT] = {0xD32F2F, 0x263238, 0x8E99A4};
+
+lv_obj_t *view_obj = nullptr;
+uint16_t column_count = 0;
+int rssi_min_dbm = -110;
+int rssi_max_dbm = -35;
+bool highlight_active = false;
+// Bar heights in pixels, as last drawn.
+int16_t column_height[SPECTRUM_VIEW_MAX_COLUMNS] = {0};
+// Trace marker heights in pixels, same scale as the bars.
+int16_t trace_height[TRACE_KIND_COUNT][SPECTRUM_VIEW_MAX_COLUMNS] = {{0}};
+bool traces_visible = true;
+bool traces_valid = false;
+
+SpectrumViewMode view_mode = SPECTRUM_VIEW_BARS;
+SweepHistory history;
+// Waterfall bitmap as a ring of RGB565 rows: scrolling moves wf_head, pixels never move.
+uint16_t *wf_pixels = nullptr;
+int32_t wf_w = 0;
+int32_t wf_h = 0;
+int32_t wf_head = 0;
+int32_t wf_rows = 0;
+lv_image_dsc_t wf_top_img = {};
+lv_image_dsc_t wf_bottom_img = {};
+// RSSI (1 dB steps from rssi_min_dbm) to RGB565.
+uint16_t rssi_lut[kLutSize] = {0};
+
+void *alloc_psram(size_t bytes) {
+    void *ptr = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!ptr) {
+        ptr = heap_caps_malloc(bytes, MALLOC_CAP_8BIT);
+    }
+    return ptr;
+}
+
+uint8_t lerp_u8(uint8_t a, uint8_t b, int32_t num, int32_t den) {
+    return static_cast<uint8_t>(a + ((static_cast<int32_t>(b) - a) * num) / den);
+}
+
+void build_rssi_lut() {
+    constexpr int stop_count = sizeof(kWaterfallStops) / sizeof(kWaterfallStops[0]);
+    const int range = (rssi_max_dbm > rssi_min_dbm) ? rssi_max_dbm - rssi_min_dbm : 1;
+
+    for (int i = 0; i < kLutSize; ++i) {
+        const int32_t pos = (i >= range) ? 1024 : (i * 1024) / range;
+        const int32_t seg_len = 1024 / (stop_count - 1);
+        int seg = pos / seg_len;
+        if (seg >= stop_count - 1) {
+            seg = stop_count - 2;
+        }
+        const int32_t num = pos - seg * seg_len;
+        const uint32_t a = kWaterfallStops[seg];
+        const uint32_t b = kWaterfallStops[seg + 1];
+        const lv_color_t c = lv_color_make(lerp_u8((a >> 16) & 0xFF, (b >> 16) & 0xFF, num, seg_len),
+                                           lerp_u8((a >> 8) & 0xFF, (b >> 8) & 0xFF, num, seg_len),
+                                           lerp_u8(a & 0xFF, b & 0xFF, num, seg_len));
+        rssi_lut[i] = lv_color_to_u16(c);
+    }
+}
+
+uint16_t rssi_to_rgb565(int16_t rssi_dbm) {
+    int32_t idx = rssi_dbm - rssi_min_dbm;
+    if (idx < 0) {
+        idx = 0;
+    } else if (idx >= kLutSize) {
+        idx = kLutSize - 1;
+    }
+    return rssi_lut[idx];
+}
+
+// Renders the newest history row into the pixel ring, one row above the previous one.
+void push_waterfall_row() {
+    const int16_t *row = history.row(0);
+    if (!wf_pixels || !row) {
+        return;
+    }
+
+    wf_head = (wf_head == 0) ? wf_h - 1 : wf_head - 1;
+    uint16_t *dst = wf_pixels + static_cast<size_t>(wf_head) * wf_w;
+    const uint16_t bins = history.bin_count();
+    for (int32_t x = 0; x < wf_w; ++x) {
+        dst[x] = rssi_to_rgb565(row[(x * bins) / wf_w]);
+    }
+    if (wf_rows < wf_h) {
+        wf_rows++;
+    }
+}
+
+void set_image(lv_image_dsc_t *img, const uint16_t *data, int32_t rows) {
+    img->header.magic = LV_IMAGE_HEADER_MAGIC;
+    img->header.cf = LV_COLOR_FORMAT_RGB565;
+    img->header.w = wf_w;
+    img->header.h = rows;
+    img->header.stride = wf_w * sizeof(uint16_t);
+    img->data_size = static_cast<uint32_t>(rows) * wf_w * sizeof(uint16_t);
+    img->data = reinterpret_cast<const uint8_t *>(data);
+}
+
+// Newest rows sit at wf_head..end of the ring, older ones wrap around to the start:
+// two image blits, newest on top, instead of memmoving the whole bitmap.
+void draw_waterfall(lv_layer_t *layer, const lv_area_t &content) {
+    if (!wf_pixels || wf_rows == 0) {
+        return;
+    }
+
+    const int32_t top_rows = (wf_h - wf_head < wf_rows) ? wf_h - wf_head : wf_rows;
+    const int32_t bottom_rows = wf_rows - top_rows;
+
+    lv_draw_image_dsc_t dsc;
+    lv_draw_image_dsc_init(&dsc);
+
+    set_image(&wf_top_img, wf_pixels + static_cast<size_t>(wf_head) * wf_w, top_rows);
+    lv_image_cache_drop(&wf_top_img);
+    dsc.src = &wf_top_img;
+    lv_area_t area = {content.x1, content.y1, content.x1 + wf_w - 1, content.y1 + top_rows - 1};
+    lv_draw_image(layer, &dsc, &area);
+
+    if (bottom_rows > 0) {
+        set_image(&wf_bottom_img, wf_pixels, bottom_rows);
+        lv_image_cache_drop(&wf_bottom_img);
+        dsc.src = &wf_bottom_img;
+        area.y1 = content.y1 + top_rows;
+        area.y2 = area.y1 + bottom_rows - 1;
+        lv_draw_image(layer, &dsc, &area);
+    }
+}
+
+int32_t clamp_i32(int32_t value, int32_t min_value, int32_t max_value) {
+    if (value < min_value) {
+        return min_value;
+    }
+    if (value > max_value) {
+        return max_value;
+    }
+    return value;
+}
+
+int16_t rssi_to_height(int rssi_dbm, int32_t plot_h) {
+    const int range = rssi_max_dbm - rssi_min_dbm;
+    if (range <= 0) {
+        return kMinBarHeight;
+    }
+    const int32_t clamped = clamp_i32(rssi_dbm, rssi_min_dbm, rssi_max_dbm);
+    const int32_t mapped = (clamped - rssi_min_dbm) * (plot_h - kMinBarHeight) / range;
+    return static_cast<int16_t>(clamp_i32(mapped, kMinBarHeight, plot_h));
+}
+
+int32_t bar_width(const lv_area_t &content) {
+    const int32_t w = (lv_area_get_width(&content) - (column_count + 1) * kBarGap) / column_count;
+    return (w < 1) ? 1 : w;
+}
+
+// Full-height slot of one column, in absolute coordinates.
+void column_area(const lv_area_t &content, int32_t bar_w, uint16_t column, lv_area_t *out_area) {
+    const int32_t used_w = column_count * bar_w + (column_count - 1) * kBarGap;
+    int32_t x0 = (lv_area_get_width(&content) - used_w) / 2;
+    if (x0 < 0) {
+        x0 = 0;
+    }
+    out_area->x1 = content.x1 + x0 + column * (bar_w + kBarGap);
+    out_area->x2 = out_area->x1 + bar_w - 1;
+    out_area->y1 = content.y1;
+    out_area->y2 = content.y2;
+}
+
+// Short horizontal ticks at each trace level, drawn over the bar of the same column.
+void draw_trace_markers(lv_layer_t *layer, const lv_area_t &slot, uint16_t column) {
+    lv_draw_rect_dsc_t dsc;
+    lv_draw_rect_dsc_init(&dsc);
+    dsc.bg_opa = LV_OPA_COVER;
+    dsc.radius = 0;
+
+    for (uint8_t t = 0; t < TRACE_KIND_COUNT; ++t) {
+        lv_area_t marker = slot;
+        marker.y1 = slot.y2 - trace_height[t][column] + 1;
+        marker.y2 = marker.y1 + kTraceMarkerHeight - 1;
+        if (marker.y2 > slot.y2) {
+            marker.y2 = slot.y2;
+        }
+        dsc.bg_color = lv_color_hex(kTraceColors[t]);
+        lv_draw_rect(layer, &dsc, &marker);
+    }
+}
+
+void draw_event_cb(lv_event_t *e) {
+    if (column_count == 0) {
+        return;
+    }
+
+    lv_layer_t *layer = lv_event_get_layer(e);
+    lv_area_t content;
+    lv_obj_get_content_coords(view_obj, &content);
+
+    if (view_mode == SPECTRUM_VIEW_WATERFALL) {
+        draw_waterfall(layer, content);
+        return;
+    }
+
+    const int32_t bar_w = bar_width(content);
+
+    lv_draw_rect_dsc_t dsc;
+    lv_draw_rect_dsc_init(&dsc);
+    dsc.bg_color = lv_color_hex(highlight_active ? kColorSignal : kColorIdle);
+    dsc.bg_opa = LV_OPA_COVER;
+    dsc.radius = 0;
+
+    for (uint16_t i = 0; i < column_count; ++i) {
+        lv_area_t bar;
+        column_area(content, bar_w, i, &bar);
+        // LVGL clips every rectangle to the invalidated area, so unchanged columns cost no pixels.
+        const lv_area_t slot = bar;
+        // Bars are anchored at the bottom of the plot area.
+        bar.y1 = bar.y2 - column_height[i] + 1;
+        lv_draw_rect(layer, &dsc, &bar);
+
+        if (traces_visible && traces_valid) {
+            draw_trace_markers(layer, slot, i);
+        }
+    }
+}
+
+void click_event_cb(lv_event_t *e) {
+    (void)e;
+    spectrum_view_set_mode((view_mode == SPECTRUM_VIEW_BARS) ? SPECTRUM_VIEW_WATERFALL : SPECTRUM_VIEW_BARS);
+}
+
+void long_press_event_cb(lv_event_t *e) {
+    (void)e;
+    spectrum_view_set_traces_visible(!traces_visible);
+}
+
+uint16_t resample_index(uint16_t column, uint16_t sample_count) {
+    return static_cast<uint16_t>((static_cast<uint32_t>(column) * (sample_count - 1)) / (column_count - 1));
+}
+
+}  // namespace
+
+lv_obj_t *spectrum_view_create(lv_obj_t *parent,
+                               int32_t width,
+                               int32_t height,
+                               uint16_t columns,
+                               uint16_t history_bins,
+                               uint16_t history_rows) {
+    column_count = (columns > SPECTRUM_VIEW_MAX_COLUMNS) ? SPECTRUM_VIEW_MAX_COLUMNS : columns;
+    for (uint16_t i = 0; i < column_count; ++i) {
+        column_height[i] = kMinBarHeight;
+    }
+
+    view_obj = lv_obj_create(parent);
+    lv_obj_set_size(view_obj, width, height);
+    lv_obj_set_style_bg_color(view_obj, lv_color_hex(0xF3F6FA), 0);
+    lv_obj_set_style_bg_opa(view_obj, LV_OPA_COVER, 0);
+    lv_obj_set_style_border_color(view_obj, lv_color_hex(0xCCCCCC), 0);
+    lv_obj_set_style_border_width(view_obj, kBorderWidth, 0);
+    lv_obj_set_style_pad_all(view_obj, 0, 0);
+    lv_obj_set_style_radius(view_obj, 0, 0);
+    lv_obj_clear_flag(view_obj, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_event_cb(view_obj, draw_event_cb, LV_EVENT_DRAW_MAIN_END, nullptr);
+    // SHORT_CLICKED so that a long press does not also switch the view mode.
+    lv_obj_add_event_cb(view_obj, click_event_cb, LV_EVENT_SHORT_CLICKED, nullptr);
+    lv_obj_add_event_cb(view_obj, long_press_event_cb, LV_EVENT_LONG_PRESSED, nullptr);
+
+    // Waterfall ring and sweep history live in PSRAM.
+    wf_w = width - 2 * kBorderWidth;
+    wf_h = height - 2 * kBorderWidth;
+    wf_pixels = static_cast<uint16_t *>(alloc_psram(static_cast<size_t>(wf_w) * wf_h * sizeof(uint16_t)));
+    int16_t *history_data = static_cast<int16_t *>(alloc_psram(SweepHistory::storage_bytes(history_rows, history_bins)));
+    uint32_t *history_ts = static_cast<uint32_t *>(alloc_psram(history_rows * sizeof(uint32_t)));
+    if (!wf_pixels || !history.init(history_data, history_ts, history_rows, history_bins)) {
+        Serial.println("[UI] waterfall: allocation PSRAM impossible");
+    }
+    build_rssi_lut();
+    return view_obj;
+}
+
+void spectrum_view_set_rssi_range(int min_dbm, int max_dbm) {
+    rssi_min_dbm = min_dbm;
+    rssi_max_dbm = max_dbm;
+    build_rssi_lut();
+    if (view_obj) {
+        lv_obj_invalidate(view_obj);
+    }
+}
+
+void spectrum_view_set_mode(SpectrumViewMode mode) {
+    if (mode == view_mode) {
+        return;
+    }
+    view_mode = mode;
+    if (view_obj) {
+        lv_obj_invalidate(view_obj);
+    }
+}
+
+SpectrumViewMode spectrum_view_get_mode() {
+    return view_mode;
+}
+
+void spectrum_view_set_traces_visible(bool visible) {
+    if (visible == traces_visible) {
+        return;
+    }
+    traces_visible = visible;
+    if (view_obj && view_mode == SPECTRUM_VIEW_BARS) {
+        lv_obj_invalidate(view_obj);
+    }
+}
+
+bool spectrum_view_get_traces_visible() {
+    return traces_visible;
+}
+
+const SweepHistory &spectrum_view_get_history() {
+    return history;
+}
+
+void spectrum_view_update(const int16_t *rssi_dbm,
+                          uint16_t sample_count,
+                          bool highlight,
+                          uint32_t timestamp_ms,
+                          const SpectrumTraceSet *traces) {
+    if (!view_obj || !rssi_dbm || sample_count < 2 || column_count < 2) {
+        return;
+    }
+
+    // History and waterfall rows are kept up to date in both modes.
+    history.push(rssi_dbm, sample_count, timestamp_ms);
+    push_waterfall_row();
+
+    lv_area_t content;
+    lv_obj_get_content_coords(view_obj, &content);
+    const int32_t plot_h = lv_area_get_height(&content);
+
+    // A colour change repaints every bar, otherwise track the changed column span.
+    // Appearing or vanishing traces repaint every column as well.
+    const bool has_traces = traces && traces->peak_dbm && traces->avg_dbm && traces->min_dbm &&
+                            traces->sample_count >= 2;
+    const bool full_repaint = (highlight != highlight_active) || (has_traces != traces_valid);
+    int32_t first_changed = full_repaint ? 0 : column_count;
+    int32_t last_changed = full_repaint ? column_count - 1 : -1;
+    highlight_active = highlight;
+    traces_valid = has_traces;
+
+    // Resample RF sweep (and traces) to fixed UI column count.
+    for (uint16_t i = 0; i < column_count; ++i) {
+        const int16_t h = rssi_to_height(rssi_dbm[resample_index(i, sample_count)], plot_h);
+        bool changed = (h != column_height[i]);
+        column_height[i] = h;
+
+        if (has_traces) {
+            const uint16_t trace_idx = resample_index(i, traces->sample_count);
+            const int16_t levels[TRACE_KIND_COUNT] = {traces->peak_dbm[trace_idx],
+                                                      traces->avg_dbm[trace_idx],
+                                                      traces->min_dbm[trace_idx]};
+            for (uint8_t t = 0; t < TRACE_KIND_COUNT; ++t) {
+                const int16_t th = rssi_to_height(levels[t], plot_h);
+                // Hidden traces are still tracked, but do not trigger redraws.
+                if (th != trace_height[t][i] && traces_visible) {
+                    changed = true;
+                }
+                trace_height[t][i] = th;
+            }
+        }
+
+        if (!changed) {
+            continue;
+        }
+        if (i < first_changed) {
+            first_changed = i;
+        }
+        if (i > last_changed) {
+            last_changed = i;
+        }
+    }
+
+    if (view_mode == SPECTRUM_VIEW_WATERFALL) {
+        // Every visible row moved down by one.
+        lv_obj_invalidate_area(view_obj, &content);
+        return;
+    }
+
+    if (last_changed < first_changed) {
+        return;
+    }
+
+    // One invalidation rectangle per frame, spanning the changed columns only.
+    const int32_t bar_w = bar_width(content);
+    lv_area_t first_area;
+    lv_area_t last_area;
+    column_area(content, bar_w, static_cast<uint16_t>(first_changed), &first_area);
+    column_area(content, bar_w, static_cast<uint16_t>(last_changed), &last_area);
+    lv_area_t dirty = {first_area.x1, content.y1, last_area.x2, content.y2};
+    lv_obj_invalidate_area(view_obj, &dirty);
+}
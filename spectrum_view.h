@@ -0,0 +1,46 @@
+#pragma once
+
+#include "lvgl.h"
+#include "sweep_history.h"
+#include <stdint.h>
+
+constexpr uint16_t SPECTRUM_VIEW_MAX_COLUMNS = 128;
+
+enum SpectrumViewMode : uint8_t {
+    SPECTRUM_VIEW_BARS = 0,
+    SPECTRUM_VIEW_WATERFALL,
+};
+
+// Running traces to overlay on the bars, one value per sweep sample.
+struct SpectrumTraceSet {
+    const int16_t *peak_dbm;
+    const int16_t *avg_dbm;
+    const int16_t *min_dbm;
+    uint16_t sample_count;
+};
+
+// Single-object spectrum plot: bars are painted from a draw callback instead of one lv_obj per bar.
+// Tapping the plot toggles between bars and the waterfall (spectrogram) view;
+// a long press toggles the peak/avg/min trace markers (bars view only).
+// The sweep history keeps history_rows sweeps of history_bins each, the sweep's own resolution
+// rather than the column count.
+lv_obj_t *spectrum_view_create(lv_obj_t *parent,
+                               int32_t width,
+                               int32_t height,
+                               uint16_t column_count,
+                               uint16_t history_bins,
+                               uint16_t history_rows);
+void spectrum_view_set_rssi_range(int rssi_min_dbm, int rssi_max_dbm);
+void spectrum_view_set_mode(SpectrumViewMode mode);
+SpectrumViewMode spectrum_view_get_mode();
+void spectrum_view_set_traces_visible(bool visible);
+bool spectrum_view_get_traces_visible();
+// Resamples one sweep to the column count, appends it to the waterfall history
+// and invalidates only what changed on screen. traces may be null.
+void spectrum_view_update(const int16_t *rssi_dbm,
+                          uint16_t sample_count,
+                          bool highlight,
+                          uint32_t timestamp_ms,
+                          const SpectrumTraceSet *traces);
+// Sweep history behind the waterfall, one row of sweep bins per sweep. UI thread only.
+const SweepHistory &spectrum_view_get_history();
@@ -0,0 +1,95 @@
+#include "sweep_history.h"
+
+bool SweepHistory::init(int16_t *rows, uint32_t *timestamps_ms, uint16_t row_capacity, uint16_t bin_count) {
+    if (!rows || !timestamps_ms || row_capacity == 0 || bin_count == 0) {
+        return false;
+    }
+    rows_ = rows;
+    timestamps_ms_ = timestamps_ms;
+    row_capacity_ = row_capacity;
+    bin_count_ = bin_count;
+    clear();
+    return true;
+}
+
+void SweepHistory::clear() {
+    head_ = 0;
+    size_ = 0;
+}
+
+void SweepHistory::push(const int16_t *rssi_dbm, uint16_t sample_count, uint32_t timestamp_ms) {
+    if (!rows_ || !rssi_dbm || sample_count == 0) {
+        return;
+    }
+
+    // Move the head one row back instead of shifting stored rows.
+    head_ = (head_ == 0) ? row_capacity_ - 1 : head_ - 1;
+    int16_t *dst = rows_ + static_cast<size_t>(head_) * bin_count_;
+    for (uint16_t i = 0; i < bin_count_; ++i) {
+        const uint32_t src_idx = (bin_count_ > 1)
+            ? (static_cast<uint32_t>(i) * (sample_count - 1)) / (bin_count_ - 1)
+            : 0;
+        dst[i] = rssi_dbm[src_idx];
+    }
+    timestamps_ms_[head_] = timestamp_ms;
+    if (size_ < row_capacity_) {
+        size_++;
+    }
+}
+
+uint16_t SweepHistory::index_for_age(uint16_t age) const {
+    return static_cast<uint16_t>((static_cast<uint32_t>(head_) + age) % row_capacity_);
+}
+
+const int16_t *SweepHistory::row(uint16_t age) const {
+    if (age >= size_) {
+        return nullptr;
+    }
+    return rows_ + static_cast<size_t>(index_for_age(age)) * bin_count_;
+}
+
+uint32_t SweepHistory::row_timestamp(uint16_t age) const {
+    if (age >= size_) {
+        return 0;
+    }
+    return timestamps_ms_[index_for_age(age)];
+}
+
+uint16_t SweepHistory::query_bin(uint16_t bin,
+                                 uint32_t now_ms,
+                                 uint32_t window_ms,
+                                 int16_t *out_rssi,
+                                 uint16_t max_out) const {
+    if (bin >= bin_count_ || !out_rssi) {
+        return 0;
+    }
+
+    uint16_t written = 0;
+    for (uint16_t age = 0; age < size_ && written < max_out; ++age) {
+        const uint16_t idx = index_for_age(age);
+        if ((now_ms - timestamps_ms_[idx]) > window_ms) {
+            break;
+        }
+        out_rssi[written++] = rows_[static_cast<size_t>(idx) * bin_count_ + bin];
+    }
+    return written;
+}
+
+int16_t SweepHistory::max_in_window(uint16_t bin, uint32_t now_ms, uint32_t window_ms) const {
+    int16_t best = INT16_MIN;
+    if (bin >= bin_count_) {
+        return best;
+    }
+
+    for (uint16_t age = 0; age < size_; ++age) {
+        const uint16_t idx = index_for_age(age);
+        if ((now_ms - timestamps_ms_[idx]) > window_ms) {
+            break;
+        }
+        const int16_t value = rows_[static_cast<size_t>(idx) * bin_count_ + bin];
+        if (value > best) {
+            best = value;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Ring of past sweeps, one row of RSSI bins per sweep, newest row first.
+// Storage is supplied by the caller (PSRAM on target) so the core stays plain C++.
+class SweepHistory {
+public:
+    static size_t storage_bytes(uint16_t row_capacity, uint16_t bin_count) {
+        return static_cast<size_t>(row_capacity) * bin_count * sizeof(int16_t);
+    }
+
+    bool init(int16_t *rows, uint32_t *timestamps_ms, uint16_t row_capacity, uint16_t bin_count);
+    void clear();
+
+    // Resamples one sweep to bin_count and stores it as the newest row.
+    void push(const int16_t *rssi_dbm, uint16_t sample_count, uint32_t timestamp_ms);
+
+    uint16_t size() const {
+        return size_;
+    }
+    uint16_t bin_count() const {
+        return bin_count_;
+    }
+    // age 0 is the newest row.
+    const int16_t *row(uint16_t age) const;
+    uint32_t row_timestamp(uint16_t age) const;
+
+    // RSSI of one bin for every row newer than window_ms, newest first. Returns samples written.
+    uint16_t query_bin(uint16_t bin, uint32_t now_ms, uint32_t window_ms, int16_t *out_rssi, uint16_t max_out) const;
+    // Strongest RSSI seen in one bin over the window, or INT16_MIN if no row matches.
+    int16_t max_in_window(uint16_t bin, uint32_t now_ms, uint32_t window_ms) const;
+
+private:
+    uint16_t index_for_age(uint16_t age) const;
+
+    int16_t *rows_ = nullptr;
+    uint32_t *timestamps_ms_ = nullptr;
+    uint16_t row_capacity_ = 0;
+    uint16_t bin_count_ = 0;
+    // Index of the newest row; rows are written backwards so age grows with the index.
+    uint16_t head_ = 0;
+    uint16_t size_ = 0;
+};
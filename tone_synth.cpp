@@ -0,0 +1,96 @@
+#include "tone_synth.h"
+
+#include <math.h>
+
+namespace {
+
+// One extra entry so interpolation never wraps inside the lookup.
+int16_t g_sine_q15[TONE_SYNTH_TABLE_SIZE + 1] = {0};
+bool g_table_ready = false;
+
+constexpr uint8_t kIndexShift = 32 - TONE_SYNTH_TABLE_BITS;
+constexpr uint32_t kFracMask = (1UL << kIndexShift) - 1;
+
+uint32_t ms_to_frames(uint32_t ms, uint32_t sample_rate) {
+    return (sample_rate * ms) / 1000;
+}
+
+}  // namespace
+
+void tone_synth_init() {
+    if (g_table_ready) {
+        return;
+    }
+    const float kTwoPi = 6.28318530717958647692f;
+    for (uint16_t i = 0; i <= TONE_SYNTH_TABLE_SIZE; ++i) {
+        g_sine_q15[i] = static_cast<int16_t>(lroundf(sinf(kTwoPi * i / TONE_SYNTH_TABLE_SIZE) * 32767.0f));
+    }
+    g_table_ready = true;
+}
+
+uint32_t ToneOscillator::step_for(uint32_t frequency_hz, uint32_t sample_rate) {
+    // phase_step = f / fs * 2^32
+    return (sample_rate > 0) ? static_cast<uint32_t>((static_cast<uint64_t>(frequency_hz) << 32) / sample_rate) : 0;
+}
+
+void ToneOscillator::set_frequency(uint32_t frequency_hz, uint32_t sample_rate) {
+    phase_step_ = step_for(frequency_hz, sample_rate);
+}
+
+int16_t ToneOscillator::next(int16_t gain_q15) {
+    const uint32_t index = phase_ >> kIndexShift;
+    // Top 15 bits of the fraction weight the step to the next entry.
+    const int32_t frac_q15 = static_cast<int32_t>((phase_ & kFracMask) >> (kIndexShift - 15));
+    const int32_t a = g_sine_q15[index];
+    const int32_t b = g_sine_q15[index + 1];
+    const int32_t sample = a + (((b - a) * frac_q15) >> 15);
+    phase_ += phase_step_;
+    return static_cast<int16_t>((sample * gain_q15) >> 15);
+}
+
+uint32_t tone_sequence_frames(const ToneSpec *tones, size_t count, uint32_t sample_rate) {
+    uint32_t frames = 0;
+    for (size_t i = 0; tones && i < count; ++i) {
+        frames += ms_to_frames(tones[i].duration_ms, sample_rate) + ms_to_frames(tones[i].gap_after_ms, sample_rate);
+    }
+    return frames;
+}
+
+uint32_t tone_render_sequence(const ToneSpec *tones,
+                              size_t count,
+                              uint32_t sample_rate,
+                              uint16_t fade_ms,
+                              int16_t *out,
+                              uint32_t max_frames) {
+    if (!tones || !out) {
+        return 0;
+    }
+    tone_synth_init();
+
+    uint32_t written = 0;
+    const uint32_t fade_frames = ms_to_frames(fade_ms, sample_rate);
+    ToneOscillator osc;
+    for (size_t t = 0; t < count; ++t) {
+        const ToneSpec &tone = tones[t];
+        const uint32_t tone_frames = ms_to_frames(tone.duration_ms, sample_rate);
+        const uint32_t gap_frames = ms_to_frames(tone.gap_after_ms, sample_rate);
+        osc.set_frequency(tone.frequency_hz, sample_rate);
+        osc.reset_phase();
+
+        // Linear ramps at both ends avoid clicks; the two ramps share short tones.
+        const uint32_t fade = (fade_frames * 2 > tone_frames) ? tone_frames / 2 : fade_frames;
+        for (uint32_t i = 0; i < tone_frames && written < max_frames; ++i) {
+            int32_t gain = tone.gain_q15;
+            if (fade > 0 && i < fade) {
+                gain = (gain * static_cast<int32_t>(i)) / static_cast<int32_t>(fade);
+            } else if (fade > 0 && i >= tone_frames - fade) {
+                gain = (gain * static_cast<int32_t>(tone_frames - i)) / static_cast<int32_t>(fade);
+            }
+            out[written++] = osc.next(static_cast<int16_t>(gain));
+        }
+        for (uint32_t i = 0; i < gap_frames && written < max_frames; ++i) {
+            out[written++] = 0;
+        }
+    }
+    return written;
+}
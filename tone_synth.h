@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+constexpr uint8_t TONE_SYNTH_TABLE_BITS = 8;
+constexpr uint16_t TONE_SYNTH_TABLE_SIZE = 1u << TONE_SYNTH_TABLE_BITS;
+
+// One beep of a sound: a sine burst with linear fade in/out, then silence.
+struct ToneSpec {
+    uint16_t frequency_hz;
+    uint16_t duration_ms;
+    // Peak amplitude, Q15.
+    int16_t gain_q15;
+    uint16_t gap_after_ms;
+};
+
+constexpr int16_t tone_gain_q15(float gain) {
+    return static_cast<int16_t>(gain * 32767.0f);
+}
+
+// Builds the Q15 sine table once; every later call is a no-op.
+void tone_synth_init();
+
+// Phase-accumulator oscillator over the sine table with linear interpolation:
+// integer only, one table lookup pair per sample.
+class ToneOscillator {
+public:
+    // Phase increment per sample for a frequency (2^32 = one cycle).
+    static uint32_t step_for(uint32_t frequency_hz, uint32_t sample_rate);
+
+    void set_frequency(uint32_t frequency_hz, uint32_t sample_rate);
+    // Raw increment, for glides that must keep the phase running.
+    void set_phase_step(uint32_t phase_step) {
+        phase_step_ = phase_step;
+    }
+    uint32_t phase_step() const {
+        return phase_step_;
+    }
+    void reset_phase() {
+        phase_ = 0;
+    }
+    // Next sample scaled by gain_q15.
+    int16_t next(int16_t gain_q15);
+
+private:
+    uint32_t phase_ = 0;
+    uint32_t phase_step_ = 0;
+};
+
+// Mono frames needed for a tone sequence, gaps included.
+uint32_t tone_sequence_frames(const ToneSpec *tones, size_t count, uint32_t sample_rate);
+// Renders a tone sequence as mono PCM; returns the frames written.
+uint32_t tone_render_sequence(const ToneSpec *tones,
+                              size_t count,
+                              uint32_t sample_rate,
+                              uint16_t fade_ms,
+                              int16_t *out,
+                              uint32_t max_frames);
@@ -0,0 +1,255 @@
+#include "trace_engine.h"
+
+#include <string.h>
+
+namespace {
+
+constexpr size_t kPieLanes = 8;
+
+int16_t sat16(int32_t value) {
+    if (value > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (value < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return static_cast<int16_t>(value);
+}
+
+#if TRACE_ENGINE_HAS_PIE
+// Each block: two 128-bit loads, one vector op, one store; pointers post-increment by 16 bytes.
+void max_blocks_pie(int16_t *acc, const int16_t *x, size_t blocks) {
+    int16_t *acc_rd = acc;
+    int16_t *acc_wr = acc;
+    const int16_t *src = x;
+    for (size_t i = 0; i < blocks; ++i) {
+        asm volatile(
+            "ee.vld.128.ip q0, %0, 16\n"
+            "ee.vld.128.ip q1, %1, 16\n"
+            "ee.vmax.s16 q2, q0, q1\n"
+            "ee.vst.128.ip q2, %2, 16\n"
+            : "+r"(acc_rd), "+r"(src), "+r"(acc_wr)
+            :
+            : "memory");
+    }
+}
+
+void min_blocks_pie(int16_t *acc, const int16_t *x, size_t blocks) {
+    int16_t *acc_rd = acc;
+    int16_t *acc_wr = acc;
+    const int16_t *src = x;
+    for (size_t i = 0; i < blocks; ++i) {
+        asm volatile(
+            "ee.vld.128.ip q0, %0, 16\n"
+            "ee.vld.128.ip q1, %1, 16\n"
+            "ee.vmin.s16 q2, q0, q1\n"
+            "ee.vst.128.ip q2, %2, 16\n"
+            : "+r"(acc_rd), "+r"(src), "+r"(acc_wr)
+            :
+            : "memory");
+    }
+}
+
+// EE.VMUL.S16 shifts products right by SAR, so SAR=15 gives the Q15 multiply.
+// SAR and the broadcast alpha are reloaded per block: the compiler may use SAR between asm statements.
+void ema_blocks_pie(int16_t *acc, const int16_t *x, size_t blocks, int16_t alpha_q15) {
+    int16_t *acc_rd = acc;
+    int16_t *acc_wr = acc;
+    const int16_t *src = x;
+    const int16_t alpha = alpha_q15;
+    const int16_t *alpha_ptr = &alpha;
+    const uint32_t shift = 15;
+    for (size_t i = 0; i < blocks; ++i) {
+        asm volatile(
+            "wsr.sar %4\n"
+            "ee.vldbc.16 q3, %3\n"
+            "ee.vld.128.ip q0, %0, 16\n"
+            "ee.vld.128.ip q1, %1, 16\n"
+            "ee.vsubs.s16 q2, q1, q0\n"
+            "ee.vmul.s16 q2, q2, q3\n"
+            "ee.vadds.s16 q0, q0, q2\n"
+            "ee.vst.128.ip q0, %2, 16\n"
+            : "+r"(acc_rd), "+r"(src), "+r"(acc_wr)
+            : "r"(alpha_ptr), "r"(shift)
+            : "memory");
+    }
+}
+
+// Cleared by a failed self-test: every call then takes the scalar path.
+bool g_pie_enabled = true;
+
+bool use_pie(const void *a, const void *b) {
+    return g_pie_enabled && ((reinterpret_cast<uintptr_t>(a) | reinterpret_cast<uintptr_t>(b)) & 0x0F) == 0;
+}
+#endif
+
+constexpr size_t kSelfTestBins = 128;
+constexpr size_t kSelfTestLengths[] = {1, 7, 8, 9, 63, 64, 100, kSelfTestBins};
+constexpr int16_t kSelfTestAlphas[] = {0, 1, 4096, 16384, 32767};
+
+// xorshift32: deterministic and free of libc state.
+uint32_t next_random(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// Half the traces span the whole int16 range to hit saturation, half look like Q4 dBm.
+void fill_random(int16_t *out, size_t n, uint32_t *state, bool full_range) {
+    for (size_t i = 0; i < n; ++i) {
+        const uint32_t r = next_random(state);
+        out[i] = full_range ? static_cast<int16_t>(r) : static_cast<int16_t>(-2048 + static_cast<int32_t>(r % 1600));
+    }
+}
+
+}  // namespace
+
+void trace_max_s16_scalar(int16_t *acc, const int16_t *x, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        if (x[i] > acc[i]) {
+            acc[i] = x[i];
+        }
+    }
+}
+
+void trace_min_s16_scalar(int16_t *acc, const int16_t *x, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        if (x[i] < acc[i]) {
+            acc[i] = x[i];
+        }
+    }
+}
+
+void trace_ema_s16_scalar(int16_t *acc, const int16_t *x, size_t n, int16_t alpha_q15) {
+    for (size_t i = 0; i < n; ++i) {
+        const int16_t diff = sat16(static_cast<int32_t>(x[i]) - acc[i]);
+        const int16_t step = static_cast<int16_t>((static_cast<int32_t>(diff) * alpha_q15) >> 15);
+        acc[i] = sat16(static_cast<int32_t>(acc[i]) + step);
+    }
+}
+
+void trace_max_s16(int16_t *acc, const int16_t *x, size_t n) {
+#if TRACE_ENGINE_HAS_PIE
+    if (use_pie(acc, x)) {
+        const size_t blocks = n / kPieLanes;
+        max_blocks_pie(acc, x, blocks);
+        const size_t done = blocks * kPieLanes;
+        trace_max_s16_scalar(acc + done, x + done, n - done);
+        return;
+    }
+#endif
+    trace_max_s16_scalar(acc, x, n);
+}
+
+void trace_min_s16(int16_t *acc, const int16_t *x, size_t n) {
+#if TRACE_ENGINE_HAS_PIE
+    if (use_pie(acc, x)) {
+        const size_t blocks = n / kPieLanes;
+        min_blocks_pie(acc, x, blocks);
+        const size_t done = blocks * kPieLanes;
+        trace_min_s16_scalar(acc + done, x + done, n - done);
+        return;
+    }
+#endif
+    trace_min_s16_scalar(acc, x, n);
+}
+
+void trace_ema_s16(int16_t *acc, const int16_t *x, size_t n, int16_t alpha_q15) {
+#if TRACE_ENGINE_HAS_PIE
+    if (use_pie(acc, x)) {
+        const size_t blocks = n / kPieLanes;
+        ema_blocks_pie(acc, x, blocks, alpha_q15);
+        const size_t done = blocks * kPieLanes;
+        trace_ema_s16_scalar(acc + done, x + done, n - done, alpha_q15);
+        return;
+    }
+#endif
+    trace_ema_s16_scalar(acc, x, n, alpha_q15);
+}
+
+bool trace_engine_self_test() {
+    alignas(16) int16_t x[kSelfTestBins];
+    alignas(16) int16_t acc[kSelfTestBins];
+    alignas(16) int16_t expected[kSelfTestBins];
+    uint32_t state = 0x2545F491;
+    bool ok = true;
+
+    for (size_t length : kSelfTestLengths) {
+        for (int round = 0; round < 4 && ok; ++round) {
+            const bool full_range = (round & 1) != 0;
+            fill_random(x, length, &state, full_range);
+            fill_random(expected, length, &state, full_range);
+            const size_t bytes = length * sizeof(int16_t);
+
+            memcpy(acc, expected, bytes);
+            trace_max_s16(acc, x, length);
+            trace_max_s16_scalar(expected, x, length);
+            ok = ok && memcmp(acc, expected, bytes) == 0;
+
+            memcpy(acc, expected, bytes);
+            trace_min_s16(acc, x, length);
+            trace_min_s16_scalar(expected, x, length);
+            ok = ok && memcmp(acc, expected, bytes) == 0;
+
+            for (int16_t alpha : kSelfTestAlphas) {
+                memcpy(acc, expected, bytes);
+                trace_ema_s16(acc, x, length, alpha);
+                trace_ema_s16_scalar(expected, x, length, alpha);
+                ok = ok && memcmp(acc, expected, bytes) == 0;
+            }
+        }
+    }
+#if TRACE_ENGINE_HAS_PIE
+    if (!ok) {
+        g_pie_enabled = false;
+    }
+#endif
+    return ok;
+}
+
+void TraceEngine::reset() {
+    bin_count_ = 0;
+    sweep_count_ = 0;
+}
+
+void TraceEngine::push(const int16_t *rssi_dbm, uint16_t bin_count) {
+    if (!rssi_dbm || bin_count == 0 || bin_count > TRACE_MAX_BINS) {
+        return;
+    }
+
+    for (uint16_t i = 0; i < bin_count; ++i) {
+        input_q4_[i] = static_cast<int16_t>(rssi_dbm[i] * (1 << TRACE_Q4_SHIFT));
+    }
+
+    // First sweep (or new sweep plan) seeds every trace.
+    if (bin_count != bin_count_ || sweep_count_ == 0) {
+        bin_count_ = bin_count;
+        memcpy(peak_q4_, input_q4_, bin_count * sizeof(int16_t));
+        memcpy(avg_q4_, input_q4_, bin_count * sizeof(int16_t));
+        memcpy(min_q4_, input_q4_, bin_count * sizeof(int16_t));
+        sweep_count_ = 1;
+        return;
+    }
+
+    trace_max_s16(peak_q4_, input_q4_, bin_count);
+    trace_min_s16(min_q4_, input_q4_, bin_count);
+    trace_ema_s16(avg_q4_, input_q4_, bin_count, alpha_q15_);
+    sweep_count_++;
+}
+
+void TraceEngine::export_dbm(int16_t *peak_dbm, int16_t *avg_dbm, int16_t *min_dbm) const {
+    for (uint16_t i = 0; i < bin_count_; ++i) {
+        if (peak_dbm) {
+            peak_dbm[i] = static_cast<int16_t>(peak_q4_[i] >> TRACE_Q4_SHIFT);
+        }
+        if (avg_dbm) {
+            avg_dbm[i] = static_cast<int16_t>(avg_q4_[i] >> TRACE_Q4_SHIFT);
+        }
+        if (min_dbm) {
+            min_dbm[i] = static_cast<int16_t>(min_q4_[i] >> TRACE_Q4_SHIFT);
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(ESP_PLATFORM)
+#include "sdkconfig.h"
+#endif
+
+// ESP32-S3 PIE (128-bit SIMD) kernels, unless forced off for comparison runs.
+#if defined(CONFIG_IDF_TARGET_ESP32S3) && !defined(TRACE_ENGINE_FORCE_SCALAR)
+#define TRACE_ENGINE_HAS_PIE 1
+#else
+#define TRACE_ENGINE_HAS_PIE 0
+#endif
+
+constexpr uint16_t TRACE_MAX_BINS = 1024;
+// Traces are kept in Q4 dBm (1/16 dB) so the running average does not stall on integer steps.
+constexpr int TRACE_Q4_SHIFT = 4;
+
+// Element-wise kernels over int16 arrays. acc and x must be 16-byte aligned for the PIE path;
+// PIE processes 8 lanes per instruction and the tail falls back to the scalar loop.
+// Scalar semantics mirror PIE: saturating add/sub, truncating arithmetic shift.
+void trace_max_s16(int16_t *acc, const int16_t *x, size_t n);
+void trace_min_s16(int16_t *acc, const int16_t *x, size_t n);
+// acc += ((x - acc) * alpha_q15) >> 15
+void trace_ema_s16(int16_t *acc, const int16_t *x, size_t n, int16_t alpha_q15);
+
+void trace_max_s16_scalar(int16_t *acc, const int16_t *x, size_t n);
+void trace_min_s16_scalar(int16_t *acc, const int16_t *x, size_t n);
+void trace_ema_s16_scalar(int16_t *acc, const int16_t *x, size_t n, int16_t alpha_q15);
+
+// Compares the kernels above with their scalar mirrors on pseudo-random traces, lengths
+// covering whole PIE blocks and scalar tails. A mismatch disables the PIE path for good and
+// returns false. About 2 KB of stack.
+bool trace_engine_self_test();
+
+// Running peak-hold, exponential average and min-hold over sweep bins.
+class TraceEngine {
+public:
+    // Default average weight: 1/8 of each new sweep.
+    static constexpr int16_t kDefaultAlphaQ15 = 4096;
+
+    void reset();
+    void set_average_alpha(int16_t alpha_q15) {
+        alpha_q15_ = alpha_q15;
+    }
+    // A bin count change restarts all traces.
+    void push(const int16_t *rssi_dbm, uint16_t bin_count);
+
+    uint16_t bin_count() const {
+        return bin_count_;
+    }
+    uint32_t sweep_count() const {
+        return sweep_count_;
+    }
+    // Export traces back to whole dBm, bin_count values each.
+    void export_dbm(int16_t *peak_dbm, int16_t *avg_dbm, int16_t *min_dbm) const;
+
+private:
+    alignas(16) int16_t input_q4_[TRACE_MAX_BINS] = {0};
+    alignas(16) int16_t peak_q4_[TRACE_MAX_BINS] = {0};
+    alignas(16) int16_t avg_q4_[TRACE_MAX_BINS] = {0};
+    alignas(16) int16_t min_q4_[TRACE_MAX_BINS] = {0};
+    uint16_t bin_count_ = 0;
+    uint32_t sweep_count_ = 0;
+    int16_t alpha_q15_ = kDefaultAlphaQ15;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+// Single-producer / single-consumer triple buffer.
+// The producer always owns one free slot, the consumer owns the one it reads,
+// and the third slot is exchanged with one atomic swap. No locks, no copies.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : middle_(1), back_(0), front_(2) {}
+
+    // Producer: slot to fill before publish(). Stays valid until publish().
+    T &write_slot() {
+        return slots_[back_];
+    }
+
+    // Producer: hand the filled slot over, take the previous middle slot back.
+    void publish() {
+        back_ = middle_.exchange(back_ | kDirtyBit, std::memory_order_acq_rel) & kIndexMask;
+    }
+
+    // Consumer: grab the newest published slot if any. Returns false when nothing new.
+    bool consume() {
+        if ((middle_.load(std::memory_order_acquire) & kDirtyBit) == 0) {
+            return false;
+        }
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask;
+        return true;
+    }
+
+    // Consumer: last slot obtained by consume(). Stays valid until the next consume().
+    const T &read_slot() const {
+        return slots_[front_];
+    }
+
+private:
+    static constexpr uint32_t kIndexMask = 0x03;
+    static constexpr uint32_t kDirtyBit = 0x04;
+
+    T slots_[3];
+    std::atomic<uint32_t> middle_;
+    // Producer-private.
+    uint32_t back_;
+    // Consumer-private.
+    uint32_t front_;
+};
@@ -1,5 +1,8 @@
 #include "ui_manager.h"
 
+#include "spectrum_view.h"
+#include "triple_buffer.h"
+
 #include <Arduino.h>
 #include <freertos/FreeRTOS.h>
 #include <stdio.h>
@@ -19,6 +22,7 @@ enum UiScreenInternal {
     SCREEN_SPECTRUM,
     SCREEN_IR,
     SCREEN_THRESHOLD,
+    SCREEN_DIAG,
 };
 
 constexpr int kScreenWidth = 640;
@@ -28,6 +32,13 @@ constexpr int kSpectrumPlotW = 620;
 constexpr int kSpectrumPlotH = 98;
 constexpr int kSpectrumRssiMin = -110;
 constexpr int kSpectrumRssiMax = -35;
+// Waterfall history span, in sweeps at the rate given by ui_manager_set_spectrum_sweep.
+constexpr uint32_t kSpectrumHistorySeconds = 30;
+constexpr int kThresholdMinDbm = -120;
+constexpr int kThresholdMaxDbm = -30;
+constexpr int kNoiseMarginMinDb = 3;
+constexpr int kNoiseMarginMaxDb = 40;
+constexpr uint32_t kDiagRefreshMs = 1000;
 
 lv_obj_t *main_screen = nullptr;
 lv_obj_t *freq_label = nullptr;
@@ -40,6 +51,7 @@ lv_obj_t *battery_label = nullptr;
 
 lv_obj_t *screen_freq_only = nullptr;
 lv_obj_t *freq_only_label = nullptr;
+lv_obj_t *freq_only_sonify_label = nullptr;
 
 lv_obj_t *screen_menu = nullptr;
 lv_obj_t *menu_title_label = nullptr;
@@ -50,13 +62,17 @@ lv_obj_t *menu_hint_label = nullptr;
 lv_obj_t *screen_spectrum = nullptr;
 lv_obj_t *spectrum_info_label = nullptr;
 lv_obj_t *spectrum_plot = nullptr;
-lv_obj_t *spectrum_bars[kSpectrumPointCount] = {nullptr};
 
 lv_obj_t *screen_ir = nullptr;
 
 lv_obj_t *screen_threshold = nullptr;
 lv_obj_t *threshold_slider = nullptr;
 lv_obj_t *threshold_value_label = nullptr;
+lv_obj_t *threshold_mode_switch = nullptr;
+
+lv_obj_t *screen_diag = nullptr;
+lv_obj_t *diag_text_label = nullptr;
+lv_timer_t *diag_timer = nullptr;
 
 lv_obj_t *splash_screen = nullptr;
 lv_timer_t *splash_timer = nullptr;
@@ -69,12 +85,12 @@ int pending_rssi = 0;
 char pending_mod[32] = "";
 char pending_status[64] = "";
 
-volatile bool spectrum_needs_update = false;
-Cc1101SweepResult pending_spectrum = {};
+// Sweep frames bypass ui_data_mux: ~280 bytes are too much to copy with interrupts off.
+TripleBuffer<SpectrumFrame> spectrum_frames;
 
 volatile bool battery_needs_update = false;
 uint8_t pending_battery_state = 0;
-float pending_battery_voltage = 0.0f;
+uint8_t pending_battery_percent = 0;
 
 float last_freq_mhz = 0.0f;
 int last_rssi_dbm = -120;
@@ -83,8 +99,19 @@ char last_modulation[16] = "----";
 int rssi_threshold = -60;
 UiThresholdChangedCb on_threshold_changed = nullptr;
 UiThresholdSavedCb on_threshold_saved = nullptr;
+bool relative_threshold = false;
+int noise_margin_db = 10;
+UiRelativeThresholdCb on_relative_threshold_changed = nullptr;
 UiSplashDoneCb on_splash_done = nullptr;
+UiUpdateQueuedCb on_update_queued = nullptr;
+UiSonifyCycleCb on_sonify_cycle = nullptr;
+UiDiagTextCb on_diag_text = nullptr;
+uint16_t spectrum_sweep_bins = kSpectrumPointCount;
+uint16_t spectrum_sweeps_per_s = 10;
+const char *sonify_name = nullptr;
 volatile UiScreenInternal active_screen = SCREEN_SPLASH;
+// Screen locked: nothing is rendered and pending data waits for the unlock.
+bool ui_suspended = false;
 
 void load_screen(lv_obj_t *screen, UiScreenInternal screen_id) {
     if (!screen) {
@@ -146,63 +173,38 @@ const char *battery_symbol_for_state(uint8_t state) {
     }
 }
 
-void update_battery_ui(uint8_t battery_state, float battery_voltage) {
-    (void)battery_voltage;
+void update_battery_ui(uint8_t battery_state, uint8_t battery_percent) {
     if (!battery_label) {
         return;
     }
-    lv_label_set_text(battery_label, battery_symbol_for_state(battery_state));
-}
-
-int clamp_int(int value, int min_value, int max_value) {
-    if (value < min_value) {
-        return min_value;
-    }
-    if (value > max_value) {
-        return max_value;
-    }
-    return value;
-}
-
-int rssi_to_bar_height(int rssi_dbm) {
-    const int clamped = clamp_int(rssi_dbm, kSpectrumRssiMin, kSpectrumRssiMax);
-    const int range = kSpectrumRssiMax - kSpectrumRssiMin;
-    if (range <= 0) {
-        return 2;
-    }
-    const int mapped = (clamped - kSpectrumRssiMin) * (kSpectrumPlotH - 2) / range;
-    return clamp_int(mapped, 2, kSpectrumPlotH);
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%u%% %s", static_cast<unsigned>(battery_percent), battery_symbol_for_state(battery_state));
+    lv_label_set_text(battery_label, buf);
 }
 
-void update_spectrum_visual(const Cc1101SweepResult &sweep) {
+void update_spectrum_visual(const SpectrumFrame &frame) {
+    const Cc1101SweepResult &sweep = frame.sweep;
     if (!sweep.valid || sweep.sample_count < 2 || !spectrum_plot) {
         return;
     }
 
     const bool signal_detected = (sweep.max_rssi_dbm >= rssi_threshold);
-    const lv_color_t color = signal_detected ? lv_color_hex(0xF05A28) : lv_color_hex(0x1E88E5);
-
-    // Resample RF sweep to fixed UI bin count.
-    for (uint16_t i = 0; i < kSpectrumPointCount; ++i) {
-        const uint16_t src_idx = static_cast<uint16_t>(
-            (static_cast<uint32_t>(i) * (sweep.sample_count - 1)) / (kSpectrumPointCount - 1));
-        const int h = rssi_to_bar_height(sweep.rssi_dbm[src_idx]);
-        if (spectrum_bars[i]) {
-            // Bars are anchored at the bottom of the plot area.
-            lv_obj_set_height(spectrum_bars[i], h);
-            lv_obj_set_y(spectrum_bars[i], kSpectrumPlotH - h);
-            lv_obj_set_style_bg_color(spectrum_bars[i], color, 0);
-        }
-    }
+    SpectrumTraceSet traces = {frame.peak_dbm, frame.avg_dbm, frame.min_dbm, sweep.sample_count};
+    spectrum_view_update(sweep.rssi_dbm,
+                         sweep.sample_count,
+                         signal_detected,
+                         sweep.timestamp_ms,
+                         frame.traces_valid ? &traces : nullptr);
 
     if (spectrum_info_label) {
         char info[96];
         snprintf(info,
                  sizeof(info),
-                 "%s | Max %.3f MHz | %d dBm",
+                 "%s | Max %.3f MHz | %d dBm | %u pic(s)",
                  signal_detected ? "Signal detecte" : "En attente",
                  sweep.max_freq_mhz,
-                 sweep.max_rssi_dbm);
+                 sweep.max_rssi_dbm,
+                 static_cast<unsigned>(sweep.peak_count));
         lv_label_set_text(spectrum_info_label, info);
     }
 }
@@ -221,6 +223,34 @@ void menu_ir_card_event_cb(lv_event_t *e) {
     load_screen(screen_ir, SCREEN_IR);
 }
 
+void refresh_diag() {
+    if (!diag_text_label || !on_diag_text) {
+        return;
+    }
+    char buf[512];
+    on_diag_text(buf, sizeof(buf));
+    lv_label_set_text(diag_text_label, buf);
+}
+
+void diag_timer_cb(lv_timer_t *timer) {
+    (void)timer;
+    if (active_screen == SCREEN_DIAG && !ui_suspended) {
+        refresh_diag();
+    }
+}
+
+void menu_gesture_event_cb(lv_event_t *e) {
+    if (lv_event_get_code(e) != LV_EVENT_GESTURE) {
+        return;
+    }
+
+    const lv_dir_t dir = lv_indev_get_gesture_dir(lv_indev_get_act());
+    if (dir == LV_DIR_TOP) {
+        refresh_diag();
+        load_screen(screen_diag, SCREEN_DIAG);
+    }
+}
+
 void ir_gesture_event_cb(lv_event_t *e) {
     if (lv_event_get_code(e) != LV_EVENT_GESTURE) {
         return;
@@ -267,15 +297,62 @@ void swipe_event_cb(lv_event_t *e) {
     }
 }
 
-void threshold_slider_event_cb(lv_event_t *e) {
-    rssi_threshold = lv_slider_get_value((lv_obj_t *)lv_event_get_target(e));
+void format_threshold(char *buf, size_t len, const char *prefix) {
+    if (relative_threshold) {
+        snprintf(buf, len, "%s+%d dB / bruit", prefix, noise_margin_db);
+    } else {
+        snprintf(buf, len, "%s%d dBm", prefix, rssi_threshold);
+    }
+}
 
-    char buf[24];
-    snprintf(buf, sizeof(buf), "%d dBm", rssi_threshold);
-    lv_label_set_text(threshold_value_label, buf);
+void refresh_threshold_labels() {
+    char buf[32];
+    if (threshold_value_label) {
+        format_threshold(buf, sizeof(buf), "");
+        lv_label_set_text(threshold_value_label, buf);
+    }
+    if (threshold_label) {
+        format_threshold(buf, sizeof(buf), "Seuil: ");
+        lv_label_set_text(threshold_label, buf);
+    }
+}
+
+// The slider edits the absolute threshold or the noise margin, depending on the mode.
+void configure_threshold_slider() {
+    if (!threshold_slider) {
+        return;
+    }
+    if (relative_threshold) {
+        lv_slider_set_range(threshold_slider, kNoiseMarginMinDb, kNoiseMarginMaxDb);
+        lv_slider_set_value(threshold_slider, noise_margin_db, LV_ANIM_OFF);
+    } else {
+        lv_slider_set_range(threshold_slider, kThresholdMinDbm, kThresholdMaxDbm);
+        lv_slider_set_value(threshold_slider, rssi_threshold, LV_ANIM_OFF);
+    }
+}
 
-    if (on_threshold_changed) {
-        on_threshold_changed(rssi_threshold);
+void threshold_slider_event_cb(lv_event_t *e) {
+    const int value = lv_slider_get_value((lv_obj_t *)lv_event_get_target(e));
+    if (relative_threshold) {
+        noise_margin_db = value;
+        if (on_relative_threshold_changed) {
+            on_relative_threshold_changed(relative_threshold, noise_margin_db);
+        }
+    } else {
+        rssi_threshold = value;
+        if (on_threshold_changed) {
+            on_threshold_changed(rssi_threshold);
+        }
+    }
+    refresh_threshold_labels();
+}
+
+void threshold_mode_event_cb(lv_event_t *e) {
+    relative_threshold = lv_obj_has_state((lv_obj_t *)lv_event_get_target(e), LV_STATE_CHECKED);
+    configure_threshold_slider();
+    refresh_threshold_labels();
+    if (on_relative_threshold_changed) {
+        on_relative_threshold_changed(relative_threshold, noise_margin_db);
     }
 }
 
@@ -287,12 +364,7 @@ void threshold_back_btn_cb(lv_event_t *e) {
     if (on_threshold_saved) {
         on_threshold_saved(rssi_threshold);
     }
-
-    if (threshold_label) {
-        char buf[32];
-        snprintf(buf, sizeof(buf), "Seuil: %d dBm", rssi_threshold);
-        lv_label_set_text(threshold_label, buf);
-    }
+    refresh_threshold_labels();
 
     load_screen(screen_freq_only, SCREEN_FREQ_ONLY);
 }
@@ -370,10 +442,12 @@ void create_menu_screen() {
     lv_obj_align(ir_subtitle, LV_ALIGN_BOTTOM_MID, 0, -16);
 
     menu_hint_label = lv_label_create(screen_menu);
-    lv_label_set_text(menu_hint_label, "Tap pour ouvrir");
+    lv_label_set_text(menu_hint_label, "Tap pour ouvrir | Swipe bas -> haut: diagnostic");
     lv_obj_set_style_text_font(menu_hint_label, &lv_font_montserrat_14, 0);
     lv_obj_set_style_text_color(menu_hint_label, lv_color_hex(0x555555), 0);
     lv_obj_align(menu_hint_label, LV_ALIGN_BOTTOM_MID, 0, -8);
+
+    lv_obj_add_event_cb(screen_menu, menu_gesture_event_cb, LV_EVENT_GESTURE, nullptr);
 }
 
 void create_ir_screen() {
@@ -403,6 +477,30 @@ void create_ir_screen() {
     lv_obj_add_event_cb(screen_ir, ir_gesture_event_cb, LV_EVENT_GESTURE, nullptr);
 }
 
+// Energy / activity counters per subsystem, text provided by on_diag_text.
+void create_diag_screen() {
+    screen_diag = lv_obj_create(nullptr);
+    lv_obj_set_size(screen_diag, kScreenWidth, kScreenHeight);
+    lv_obj_set_style_bg_color(screen_diag, lv_color_white(), 0);
+    lv_obj_set_style_bg_opa(screen_diag, LV_OPA_COVER, 0);
+
+    lv_obj_t *title = lv_label_create(screen_diag);
+    lv_label_set_text(title, "Diagnostic energie (estimation)");
+    lv_obj_set_style_text_font(title, &lv_font_montserrat_14, 0);
+    lv_obj_set_style_text_color(title, lv_color_black(), 0);
+    lv_obj_align(title, LV_ALIGN_TOP_LEFT, 8, 4);
+
+    diag_text_label = lv_label_create(screen_diag);
+    lv_label_set_text(diag_text_label, "---");
+    lv_obj_set_style_text_font(diag_text_label, &lv_font_montserrat_14, 0);
+    lv_obj_set_style_text_color(diag_text_label, lv_color_hex(0x333333), 0);
+    lv_obj_align(diag_text_label, LV_ALIGN_TOP_LEFT, 8, 24);
+
+    // IR screen gesture handler: swipe down returns to the menu.
+    lv_obj_add_event_cb(screen_diag, ir_gesture_event_cb, LV_EVENT_GESTURE, nullptr);
+    diag_timer = lv_timer_create(diag_timer_cb, kDiagRefreshMs, nullptr);
+}
+
 void create_threshold_screen() {
     screen_threshold = lv_obj_create(nullptr);
     lv_obj_set_style_bg_color(screen_threshold, lv_color_white(), 0);
@@ -417,14 +515,23 @@ void create_threshold_screen() {
     lv_obj_center(back_lbl);
 
     threshold_value_label = lv_label_create(screen_threshold);
-    char buf[24];
-    snprintf(buf, sizeof(buf), "%d dBm", rssi_threshold);
-    lv_label_set_text(threshold_value_label, buf);
     lv_obj_align(threshold_value_label, LV_ALIGN_TOP_MID, 0, 20);
 
+    // Mode toggle: absolute level, or margin above each channel's noise floor.
+    threshold_mode_switch = lv_switch_create(screen_threshold);
+    lv_obj_align(threshold_mode_switch, LV_ALIGN_TOP_RIGHT, -10, 14);
+    if (relative_threshold) {
+        lv_obj_add_state(threshold_mode_switch, LV_STATE_CHECKED);
+    }
+    lv_obj_add_event_cb(threshold_mode_switch, threshold_mode_event_cb, LV_EVENT_VALUE_CHANGED, nullptr);
+
+    lv_obj_t *mode_lbl = lv_label_create(screen_threshold);
+    lv_label_set_text(mode_lbl, "Relatif au bruit");
+    lv_obj_align_to(mode_lbl, threshold_mode_switch, LV_ALIGN_OUT_LEFT_MID, -8, 0);
+
     threshold_slider = lv_slider_create(screen_threshold);
-    lv_slider_set_range(threshold_slider, -120, -30);
-    lv_slider_set_value(threshold_slider, rssi_threshold, LV_ANIM_OFF);
+    configure_threshold_slider();
+    refresh_threshold_labels();
     lv_obj_set_size(threshold_slider, 580, 30);
     lv_obj_align(threshold_slider, LV_ALIGN_CENTER, 0, 10);
     lv_obj_add_event_cb(threshold_slider, threshold_slider_event_cb, LV_EVENT_VALUE_CHANGED, nullptr);
@@ -432,6 +539,23 @@ void create_threshold_screen() {
     lv_obj_add_event_cb(screen_threshold, swipe_event_cb, LV_EVENT_GESTURE, nullptr);
 }
 
+void set_sonify_label(const char *name) {
+    if (!freq_only_sonify_label) {
+        return;
+    }
+    char buf[32];
+    snprintf(buf, sizeof(buf), "Son: %s", name ? name : "Off");
+    lv_label_set_text(freq_only_sonify_label, buf);
+}
+
+void freq_only_long_press_cb(lv_event_t *e) {
+    (void)e;
+    if (on_sonify_cycle) {
+        sonify_name = on_sonify_cycle();
+        set_sonify_label(sonify_name);
+    }
+}
+
 void create_freq_only_screen() {
     screen_freq_only = lv_obj_create(nullptr);
     lv_obj_set_style_bg_color(screen_freq_only, lv_color_white(), 0);
@@ -442,7 +566,14 @@ void create_freq_only_screen() {
     lv_obj_set_style_text_color(freq_only_label, lv_color_black(), 0);
     lv_obj_center(freq_only_label);
 
+    freq_only_sonify_label = lv_label_create(screen_freq_only);
+    lv_obj_set_style_text_font(freq_only_sonify_label, &lv_font_montserrat_14, 0);
+    lv_obj_set_style_text_color(freq_only_sonify_label, lv_color_hex(0x666666), 0);
+    lv_obj_align(freq_only_sonify_label, LV_ALIGN_BOTTOM_MID, 0, -8);
+    set_sonify_label(sonify_name);
+
     lv_obj_add_event_cb(screen_freq_only, swipe_event_cb, LV_EVENT_GESTURE, nullptr);
+    lv_obj_add_event_cb(screen_freq_only, freq_only_long_press_cb, LV_EVENT_LONG_PRESSED, nullptr);
 }
 
 void create_spectrum_screen() {
@@ -463,51 +594,33 @@ void create_spectrum_screen() {
     lv_obj_align(spectrum_info_label, LV_ALIGN_TOP_LEFT, 8, 30);
 
     lv_obj_t *range_label = lv_label_create(screen_spectrum);
-    lv_label_set_text(range_label, "Bande: 433.05 MHz <-> 434.79 MHz");
+    lv_label_set_text(range_label, "Bande: 433.05 MHz <-> 434.79 MHz | Tap: barres / cascade | Appui long: traces");
     lv_obj_set_style_text_font(range_label, &lv_font_montserrat_14, 0);
     lv_obj_set_style_text_color(range_label, lv_color_hex(0x666666), 0);
     lv_obj_align(range_label, LV_ALIGN_TOP_LEFT, 8, 52);
 
-    // Plot container where custom bar objects are drawn.
-    spectrum_plot = lv_obj_create(screen_spectrum);
-    lv_obj_set_size(spectrum_plot, kSpectrumPlotW, kSpectrumPlotH);
+    // Plot widget: one object, bars painted in its draw callback.
+    const uint32_t history_rows = kSpectrumHistorySeconds * spectrum_sweeps_per_s;
+    spectrum_plot = spectrum_view_create(screen_spectrum,
+                                         kSpectrumPlotW,
+                                         kSpectrumPlotH,
+                                         kSpectrumPointCount,
+                                         spectrum_sweep_bins,
+                                         static_cast<uint16_t>((history_rows > UINT16_MAX) ? UINT16_MAX : history_rows));
+    spectrum_view_set_rssi_range(kSpectrumRssiMin, kSpectrumRssiMax);
     lv_obj_align(spectrum_plot, LV_ALIGN_BOTTOM_MID, 0, -6);
-    lv_obj_set_style_bg_color(spectrum_plot, lv_color_hex(0xF3F6FA), 0);
-    lv_obj_set_style_bg_opa(spectrum_plot, LV_OPA_COVER, 0);
-    lv_obj_set_style_border_color(spectrum_plot, lv_color_hex(0xCCCCCC), 0);
-    lv_obj_set_style_border_width(spectrum_plot, 1, 0);
-    lv_obj_set_style_pad_all(spectrum_plot, 0, 0);
-    lv_obj_set_style_radius(spectrum_plot, 0, 0);
-    lv_obj_clear_flag(spectrum_plot, LV_OBJ_FLAG_SCROLLABLE);
-
-    const int gap = 1;
-    int bar_w = (kSpectrumPlotW - (kSpectrumPointCount + 1) * gap) / kSpectrumPointCount;
-    if (bar_w < 1) {
-        bar_w = 1;
-    }
-    const int used_w = kSpectrumPointCount * bar_w + (kSpectrumPointCount - 1) * gap;
-    int x = (kSpectrumPlotW - used_w) / 2;
-    if (x < 0) {
-        x = 0;
-    }
-
-    for (uint16_t i = 0; i < kSpectrumPointCount; ++i) {
-        spectrum_bars[i] = lv_obj_create(spectrum_plot);
-        lv_obj_set_size(spectrum_bars[i], bar_w, 2);
-        lv_obj_set_pos(spectrum_bars[i], x, kSpectrumPlotH - 2);
-        lv_obj_set_style_bg_color(spectrum_bars[i], lv_color_hex(0x1E88E5), 0);
-        lv_obj_set_style_bg_opa(spectrum_bars[i], LV_OPA_COVER, 0);
-        lv_obj_set_style_border_width(spectrum_bars[i], 0, 0);
-        lv_obj_set_style_radius(spectrum_bars[i], 0, 0);
-        lv_obj_clear_flag(spectrum_bars[i], LV_OBJ_FLAG_SCROLLABLE);
-        x += bar_w + gap;
-    }
 
     lv_obj_add_event_cb(screen_spectrum, swipe_event_cb, LV_EVENT_GESTURE, nullptr);
 }
 
 }  // namespace
 
+void ui_manager_set_relative_threshold(bool enabled, int margin_db, UiRelativeThresholdCb on_changed) {
+    relative_threshold = enabled;
+    noise_margin_db = margin_db;
+    on_relative_threshold_changed = on_changed;
+}
+
 void ui_manager_init(int initial_threshold,
                      UiThresholdChangedCb threshold_changed_cb,
                      UiThresholdSavedCb threshold_saved_cb) {
@@ -567,7 +680,7 @@ void ui_manager_init(int initial_threshold,
 
     threshold_label = lv_label_create(main_screen);
     char buf[32];
-    snprintf(buf, sizeof(buf), "Seuil: %d dBm", rssi_threshold);
+    format_threshold(buf, sizeof(buf), "Seuil: ");
     lv_label_set_text(threshold_label, buf);
     lv_obj_set_style_text_color(threshold_label, lv_color_black(), 0);
     lv_obj_set_style_text_font(threshold_label, &lv_font_montserrat_18, 0);
@@ -583,6 +696,7 @@ void ui_manager_init(int initial_threshold,
     create_freq_only_screen();
     create_spectrum_screen();
     create_ir_screen();
+    create_diag_screen();
     create_threshold_screen();
 
     lv_obj_add_event_cb(main_screen, swipe_event_cb, LV_EVENT_GESTURE, nullptr);
@@ -608,6 +722,62 @@ void ui_manager_create_splash(UiSplashDoneCb splash_done_cb) {
     splash_timer = lv_timer_create(splash_timer_cb, 1500, nullptr);
 }
 
+void ui_manager_set_suspended(bool suspended) {
+    if (suspended == ui_suspended) {
+        return;
+    }
+    ui_suspended = suspended;
+
+    // The refresh timer drives rendering and flush; input read timers stop with it.
+    lv_display_t *disp = lv_display_get_default();
+    lv_timer_t *refr_timer = disp ? lv_display_get_refr_timer(disp) : nullptr;
+    if (refr_timer) {
+        if (suspended) {
+            lv_timer_pause(refr_timer);
+        } else {
+            lv_timer_resume(refr_timer);
+        }
+    }
+    for (lv_indev_t *indev = lv_indev_get_next(nullptr); indev; indev = lv_indev_get_next(indev)) {
+        lv_timer_t *read_timer = lv_indev_get_read_timer(indev);
+        if (!read_timer) {
+            continue;
+        }
+        if (suspended) {
+            lv_timer_pause(read_timer);
+        } else {
+            lv_timer_resume(read_timer);
+        }
+    }
+
+    if (!suspended) {
+        ui_manager_process_pending_update();
+        lv_obj_invalidate(lv_screen_active());
+    }
+}
+
+void ui_manager_set_sonify_cb(const char *initial_name, UiSonifyCycleCb on_cycle) {
+    sonify_name = initial_name;
+    on_sonify_cycle = on_cycle;
+}
+
+void ui_manager_set_diag_text_cb(UiDiagTextCb diag_text_cb) {
+    on_diag_text = diag_text_cb;
+}
+
+void ui_manager_set_spectrum_sweep(uint16_t sample_count, uint16_t sweeps_per_s) {
+    if (sample_count > 0) {
+        spectrum_sweep_bins = sample_count;
+    }
+    if (sweeps_per_s > 0) {
+        spectrum_sweeps_per_s = sweeps_per_s;
+    }
+}
+
+void ui_manager_set_update_queued_cb(UiUpdateQueuedCb on_queued) {
+    on_update_queued = on_queued;
+}
+
 void ui_manager_queue_update(float freq_mhz, int rssi, const char *modulation, const char *status) {
     // Producer side (RF task): just store latest values.
     portENTER_CRITICAL(&ui_data_mux);
@@ -626,6 +796,9 @@ void ui_manager_queue_update(float freq_mhz, int rssi, const char *modulation, c
 
     ui_needs_update = true;
     portEXIT_CRITICAL(&ui_data_mux);
+    if (on_update_queued) {
+        on_update_queued();
+    }
 }
 
 void ui_manager_set_last_signal(float freq_mhz, int rssi, const char *modulation) {
@@ -638,26 +811,38 @@ void ui_manager_set_last_signal(float freq_mhz, int rssi, const char *modulation
     }
 }
 
-void ui_manager_queue_spectrum_update(const Cc1101SweepResult &sweep) {
+SpectrumFrame *ui_manager_acquire_spectrum_frame() {
+    // Producer side (RF task): the slot is private until published.
+    return &spectrum_frames.write_slot();
+}
+
+void ui_manager_publish_spectrum_frame() {
+    const Cc1101SweepResult &sweep = spectrum_frames.write_slot().sweep;
     if (!sweep.valid || sweep.sample_count < 2 || sweep.sample_count > CC1101_SWEEP_MAX_SAMPLES) {
         return;
     }
-
-    portENTER_CRITICAL(&ui_data_mux);
-    pending_spectrum = sweep;
-    spectrum_needs_update = true;
-    portEXIT_CRITICAL(&ui_data_mux);
+    spectrum_frames.publish();
+    if (on_update_queued) {
+        on_update_queued();
+    }
 }
 
-void ui_manager_queue_battery_update(uint8_t battery_state, float battery_voltage) {
+void ui_manager_queue_battery_update(uint8_t battery_state, uint8_t battery_percent) {
     portENTER_CRITICAL(&ui_data_mux);
     pending_battery_state = battery_state;
-    pending_battery_voltage = battery_voltage;
+    pending_battery_percent = battery_percent;
     battery_needs_update = true;
     portEXIT_CRITICAL(&ui_data_mux);
+    if (on_update_queued) {
+        on_update_queued();
+    }
 }
 
 void ui_manager_process_pending_update() {
+    // Pending slots keep only the latest values, so the unlock replays the current state.
+    if (ui_suspended) {
+        return;
+    }
     // Consumer side (UI thread): copy pending data then render.
     bool do_ui = false;
     float local_freq = 0.0f;
@@ -665,12 +850,9 @@ void ui_manager_process_pending_update() {
     char local_mod[sizeof(pending_mod)] = "";
     char local_status[sizeof(pending_status)] = "";
 
-    bool do_spectrum = false;
-    Cc1101SweepResult local_sweep = {};
-
     bool do_battery = false;
     uint8_t local_battery_state = 0;
-    float local_battery_voltage = 0.0f;
+    uint8_t local_battery_percent = 0;
 
     portENTER_CRITICAL(&ui_data_mux);
     if (ui_needs_update) {
@@ -682,15 +864,9 @@ void ui_manager_process_pending_update() {
         do_ui = true;
     }
 
-    if (spectrum_needs_update) {
-        local_sweep = pending_spectrum;
-        spectrum_needs_update = false;
-        do_spectrum = true;
-    }
-
     if (battery_needs_update) {
         local_battery_state = pending_battery_state;
-        local_battery_voltage = pending_battery_voltage;
+        local_battery_percent = pending_battery_percent;
         battery_needs_update = false;
         do_battery = true;
     }
@@ -700,12 +876,13 @@ void ui_manager_process_pending_update() {
         update_ui(local_freq, local_rssi, local_mod, local_status);
     }
 
-    if (do_spectrum) {
-        update_spectrum_visual(local_sweep);
+    // Newest sweep frame only; older unread frames were recycled by the producer.
+    if (spectrum_frames.consume()) {
+        update_spectrum_visual(spectrum_frames.read_slot());
     }
 
     if (do_battery) {
-        update_battery_ui(local_battery_state, local_battery_voltage);
+        update_battery_ui(local_battery_state, local_battery_percent);
     }
 }
 
@@ -7,17 +7,51 @@
 typedef void (*UiThresholdChangedCb)(int value);
 typedef void (*UiThresholdSavedCb)(int value);
 typedef void (*UiSplashDoneCb)();
+// Relative mode: detection margin above each channel's noise floor instead of an absolute level.
+typedef void (*UiRelativeThresholdCb)(bool enabled, int margin_db);
+// Called by producers after queueing data for ui_manager_process_pending_update(), from any task.
+typedef void (*UiUpdateQueuedCb)();
+// Fills the diagnostics screen text; returns the length written.
+typedef size_t (*UiDiagTextCb)(char *buf, size_t len);
+// Long press on the frequency screen: switch to the next sonification mode, return its name.
+typedef const char *(*UiSonifyCycleCb)();
 
 void ui_manager_init(int initial_threshold,
                      UiThresholdChangedCb on_threshold_changed,
                      UiThresholdSavedCb on_threshold_saved);
 void ui_manager_create_splash(UiSplashDoneCb on_splash_done);
+// Call before ui_manager_init so the threshold screen starts in the right mode.
+void ui_manager_set_relative_threshold(bool enabled, int margin_db, UiRelativeThresholdCb on_changed);
 
+// Call before ui_manager_init; initial_name labels the current sonification mode.
+void ui_manager_set_sonify_cb(const char *initial_name, UiSonifyCycleCb on_cycle);
+// Call before ui_manager_init. The diagnostics screen (menu, swipe up) refreshes once a second.
+void ui_manager_set_diag_text_cb(UiDiagTextCb on_diag_text);
+// Call before ui_manager_init: sweep size and rate, so the waterfall history holds the sweep's
+// bins and about half a minute of sweeps.
+void ui_manager_set_spectrum_sweep(uint16_t sample_count, uint16_t sweeps_per_s);
+// Lets the consumer block until something is queued instead of polling.
+void ui_manager_set_update_queued_cb(UiUpdateQueuedCb on_queued);
 void ui_manager_queue_update(float freq_mhz, int rssi, const char *modulation, const char *status);
 void ui_manager_set_last_signal(float freq_mhz, int rssi, const char *modulation);
-void ui_manager_queue_spectrum_update(const Cc1101SweepResult &sweep);
-void ui_manager_queue_battery_update(uint8_t battery_state, float battery_voltage);
+// One spectrum frame: the raw sweep plus the running traces computed by the RF task.
+struct SpectrumFrame {
+    Cc1101SweepResult sweep;
+    bool traces_valid;
+    int16_t peak_dbm[CC1101_SWEEP_MAX_SAMPLES];
+    int16_t avg_dbm[CC1101_SWEEP_MAX_SAMPLES];
+    int16_t min_dbm[CC1101_SWEEP_MAX_SAMPLES];
+};
+
+// Sweep frames are exchanged through a lock-free triple buffer:
+// the RF task fills the acquired frame in place, then publishes it.
+SpectrumFrame *ui_manager_acquire_spectrum_frame();
+void ui_manager_publish_spectrum_frame();
+void ui_manager_queue_battery_update(uint8_t battery_state, uint8_t battery_percent);
 void ui_manager_process_pending_update();
+// Screen lock: pauses display refresh, flush and touch input; resuming replays the latest queued state.
+// Call with the LVGL lock held.
+void ui_manager_set_suspended(bool suspended);
 bool ui_manager_is_spectrum_active();
 bool ui_manager_is_subghz_active();
 bool ui_manager_is_freq_only_active();